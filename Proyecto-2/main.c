@@ -1,711 +1,8007 @@
-#include <stdlib.h>
-#include <sys/types.h>
-#include <signal.h>
-#include <unistd.h>
-#include <math.h>
-#include <ctype.h>
-#include <stdio.h>
-#include <time.h>
-#include <stdbool.h>
-
-
-/*******************************Look Up Table Matrix Functions*******************************/
-/* Look Up Table
-    The creation of this look up table utilices the following reference:
-Jones, N. (2010, January 11). A tutorial on lookup tables in C «  Stack Overflow. https://embeddedgurus.com/stack-overflow/2010/01/a-tutorial-on-lookup-tables-in-c/
-*/
-
-/*******************************Principal Algorithm*******************************/
-/*Rules
-// -1 ; Frontier Cells
-// 0 ; Spanning Tree Cells
-// + 1 ; Right
-// + 2 ; Below
-// + 4 ; Left
-// + 8 ; Above
-RULES*/
-
-/*Situations
-0 ; All borders
-1 ; No right border
-2 ; No below border
-3 ; No right, below border
-4 ; No left border
-5 ; No left, right border
-6 ; No left, below border
-7 ; No right, below, left border
-8 ; No upper border
-9 ; No upper, right border
-10 ; No upper, below border
-11 ; No above, below, right border
-12 ; No left, upper border
-13 ; No left, upper, right border
-14 ; No above, left, below
-15 ; No borders
-Situations*/
-
-#define topBorder    1
-#define rightBorder  2
-#define bottomBorder 4
-#define leftBorder   8
-
-const int borders[] = {
-    topBorder | rightBorder | bottomBorder | leftBorder, // 15
-    topBorder | bottomBorder | leftBorder, // 13
-    topBorder | rightBorder | leftBorder,  // 11
-    topBorder | leftBorder, // 9
-    topBorder | rightBorder | bottomBorder, // 7
-    topBorder | bottomBorder, // 5
-    topBorder | rightBorder, // 3
-    topBorder, // 1
-    rightBorder | bottomBorder | leftBorder, // 14
-    bottomBorder | leftBorder, // 12
-    rightBorder | leftBorder, // 10
-    leftBorder, // 8
-    bottomBorder | rightBorder, // 6
-    bottomBorder, // 4
-    rightBorder, // 2
-    0
-};
-
-/*******************************General Matrix Functions*******************************/
-
-void fillMatrix(int **matrix, int rows, int columns, int value) {
-    /*
-    Subroutine that fills the array with equal values.
-    Inputs and constraints:
-        -matrix: Pointer to the matrix made up of integers to be filled with value.
-        -rows: Non-negative integer indicating the number of rows in the matrix.
-        -columns: Non-negative integer indicating the number of columns in the matrix.
-        -value: The value with which all the fields of the matrix will be filled.
-        Outputs:
-    -The matrix with all its fields with the value received by parameter.
-    */
-    for (int row = 0; row < rows; row++) {
-        for (int column = 0; column < columns; column++) {
-            matrix[row][column] = value;
-        }
-    }
-}
-
-int **createMatrix(int rows, int columns) { //
-
-    /*
-    Subroutine that is in charge of creating an array from its number of rows and columns.
-    Inputs and constraints:
-        -rows: Non-negative integer indicating the number of rows in the matrix.
-        -columns: Non-negative integer indicating the number of columns in the matrix.
-    Outputs:
-    -The correctly created matrix.
-    References:
-        -Portfolio Courses. (2022a, September 2). Return A Dynamically Allocated 2D Array From A Function | C Programming Tutorial [Video]. YouTube. https://www.youtube.com/watch?v=22wkCgsPZSU
-    */
-
-    int **matrix;
-
-    matrix = malloc(sizeof(int *) * rows); // Creates the rows
-
-    for (int row = 0; row < rows; row++) { // Creates de columns
-        matrix[row] = malloc(sizeof(int *) * columns);
-    }
-    fillMatrix(matrix, rows, columns, 0);
-
-    return matrix;
-}
-
-void freeMatrix(int **matrix, int rows) {
-   /*
-    Subroutine that returns the memory occupied by a matrix by iterating through its rows.
-    Inputs and constraints:
-        -matrix: Pointer to the matrix that will free its memory.
-        -rows: Non-negative integer indicating the number of rows in the matrix.
-    Outputs:
-        -Memory occupied by the correctly freed matrix.
-    */
-    for (int row = 0; row < rows; row++) {
-        free(matrix[row]);
-    }
-    free(matrix);
-}
-
-int initialCellStarterValue = 16;
-
-
-void printLaberynth(int **matrix, int rows, int columns) {
-    for (int i = 0; i < rows; i++) {
-        printf("[ ");
-        for (int z = 0; z < columns; z++) {
-            printf("%d, ", matrix[i][z]);
-        }
-        printf("]\n");
-    }
-
-}
-void adjacentCellsIntoFrotierCells(int **matrix, int rows, int columns, int positionX, int positionY, int *frontierCellsXPosition, int *frontierCellsYPosition, int *frotierCellsArraySize) {
-    /*
-    Subroutine that converts the adjacent cells of a given position in a matrix into frontier cells.
-    Inputs and constraints:
-        - matrix: A pointer to a two-dimensional array of integers representing the matrix.
-        - rows: The number of rows in the matrix.
-        - columns: The number of columns in the matrix.
-        - positionX: The X-coordinate of the position in the matrix whose adjacent cells to convert. coor x spanning
-        - positionY: The Y-coordinate of the position in the matrix whose adjacent cells to convert. coor y del spanning
-        - frontierCellsXPosition: A pointer to an array of integers to store the X-coordinates of the resulting frontier cells. guardo coord x en array
-        - frontierCellsYPosition: A pointer to an array of integers to store the Y-coordinates of the resulting frontier cells.  guardo coord y en array
-        - frotierCellsArraySize: A pointer to an integer to store the size of the resulting frontier cells array.
-    Outputs:
-        -The adjacent cell of the given position in the matrix into a frontier cell.
-    References:
-	-Matuszek, D. (n.d.). How to build a maze. Retrieved from https://www-fourier.ujf-grenoble.fr/~faure/enseignement/projets_simulation/labyrinthe/construct_a_maze.pdf
- */    
-
-    if (positionX - 1 >= 0 && matrix[positionX - 1][positionY] == 0) { // Up
-        matrix[positionX - 1][positionY] = -1;
-        frontierCellsXPosition[*frotierCellsArraySize] = positionX - 1;
-        frontierCellsYPosition[*frotierCellsArraySize] = positionY;
-        *frotierCellsArraySize = *frotierCellsArraySize + 1;
-    }
-
-    if (positionX + 1 < rows && matrix[positionX + 1][positionY] == 0) { // Down
-        matrix[positionX + 1][positionY] = -1;
-        frontierCellsXPosition[*frotierCellsArraySize] = positionX + 1;
-        frontierCellsYPosition[*frotierCellsArraySize] = positionY;
-        *frotierCellsArraySize = *frotierCellsArraySize + 1;
-    }
-
-    if (positionY - 1 >= 0 && matrix[positionX][positionY - 1] == 0) { // Left
-        matrix[positionX][positionY - 1] = -1;
-        frontierCellsXPosition[*frotierCellsArraySize] = positionX;
-        frontierCellsYPosition[*frotierCellsArraySize] = positionY - 1;
-        *frotierCellsArraySize = *frotierCellsArraySize + 1;
-    }
-
-    if (positionY + 1 < columns && matrix[positionX][positionY + 1] == 0) { // Right
-        matrix[positionX][positionY + 1] = -1;
-        frontierCellsXPosition[*frotierCellsArraySize] = positionX;
-        frontierCellsYPosition[*frotierCellsArraySize] = positionY + 1;
-        *frotierCellsArraySize = *frotierCellsArraySize + 1;
-    }
-}
-
-void searchRandomFrontierCell(int *positionX, int *positionY, int *frontierCellsXPosition, int *frontierCellsYPosition, int *frontierCellsArraySize) { // Searchs a random Frontier Cell
-    /*
-    Subroutine that is in charge of searching for a random border cell.
-    Inputs and constraints:
-        -positionX: Pointer to the X position of the selected cell.
-        -positionY: Pointer to the Y position of the selected cell.
-        -frontierCellsXPosition: Pointer to the array of X positions of the border cells.
-        -frontierCellsYPosition: Pointer to the array of Y positions of the border cells.
-        -positionY: Pointer to the Y position of the selected cell.
-        -frontierCellsArraySize: Pointer to the current size of the border cells array.
-    Outputs:
-        -The random frontier cell already selected.
-    References:
-	-Matuszek, D. (n.d.). How to build a maze. Retrieved from https://www-fourier.ujf-grenoble.fr/~faure/enseignement/projets_simulation/labyrinthe/construct_a_maze.pdf
-    */
-    int randomPosition = rand() % (*frontierCellsArraySize);
-    *positionX = frontierCellsXPosition[randomPosition];
-    *positionY = frontierCellsYPosition[randomPosition];
-    *frontierCellsArraySize = *frontierCellsArraySize - 1; // update size del array
-    // recorta el tamano del array
-    for (int i = randomPosition; i < *frontierCellsArraySize; i++) {
-        frontierCellsXPosition[i] = frontierCellsXPosition[i + 1];
-        frontierCellsYPosition[i] = frontierCellsYPosition[i + 1];
-    }
-}
- 
-void searchRandomSpanningTreeCell(int **matrix, int rows, int columns, int positionX, int positionY, int *randomSpanningTreeCellX, int *randomSpanningTreeCellY) { // Search a random Spanning Tree Cell adjacent to a Frontier Cell
-    /*
-    Subroutine that searches for a random cell of the spanning tree adjacent to a boundary cell in a given array.
-        -matrix: The matrix to search in.
-        -rows: The number of rows in the matrix.
-        -columns: The number of columns in the matrix.
-        -positionX: The x-position of the boundary cell.
-        -positionY: The y position of the border cell.
-        -randomSpanningTreeCellX: pointer to a variable where the x position of the random cell of the spanning tree will be stored.
-        -randomSpanningTreeCellY: A pointer to a variable where the y-position of the random Spanning Tree Cell will be stored.
-    Outputs:
-        -randomSpanningTreeCell adjacent to a boundary cell in a given matrix.
-    References:
-	-Matuszek, D. (n.d.). How to build a maze. Retrieved from https://www-fourier.ujf-grenoble.fr/~faure/enseignement/projets_simulation/labyrinthe/construct_a_maze.pdf
-    */
-
-   // si no se ha salido del borde y no esta en spanning tree ya
-    *randomSpanningTreeCellX = positionX;
-    *randomSpanningTreeCellY = positionY;
-
-    bool flag = true;                                      // -1 -1 -1 -1 -1
-                                                           // -1  7
-
-    while (flag) {    // 1,1
-        switch (rand() % 4) {  // 0  1  mat[0][1]
-        case 0: // si le resto uno a mi fila y no me he salido del borde de arriba
-            if (positionX - 1 >= 0 && matrix[positionX - 1][positionY] > 0) { // Up
-                *randomSpanningTreeCellX -= 1;
-                flag = false;
-            }
-            break;
-        case 1:// si es ultima fila y no me he salido
-            if (positionX + 1 < rows && matrix[positionX + 1][positionY] > 0) {
-                *randomSpanningTreeCellX += 1;
-                flag = false;
-            }
-            break;
-        case 2:
-            if (positionY - 1 >= 0 && matrix[positionX][positionY - 1] > 0) {
-                *randomSpanningTreeCellY -= 1;
-                flag = false;
-            }
-            break;
-        case 3:
-            if (positionY + 1 < columns && matrix[positionX][positionY + 1] > 0) {
-                *randomSpanningTreeCellY += 1;
-                flag = false;
-            }
-            break;
-        }
-    }
-}
-
-void removeBarrierCell(int **matrix, int frontierX, int frontierY, int spanningTreeCellX, int spanningTreeCellY) { // Removes a barrier cell between two coordinates
-    /*
-    Subroutine that updates a matrix to remove a barrier cell between two coordinates. Checks the relative
-    positions of the two cells and update the matrix accordingly.
-    Inputs and constraints:
-        -array: A pointer to a 2D array of integers representing the matrix.
-        -frontierX: An integer representing the x-coordinate of the cell boundary.
-        -frontierY: An integer representing the y-coordinate of the boundary cell.
-        -spanningTreeCellX: An integer representing the x-coordinate of the spanning tree cell.
-        -spanningTreeCellY: An integer representing the y-coordinate of the spanning tree cell.
-    Outputs:
-        -The matrix with the barrier cell removed between the two coordinates.
-    References:
-	-Matuszek, D. (n.d.). How to build a maze. Retrieved from https://www-fourier.ujf-grenoble.fr/~faure/enseignement/projets_simulation/labyrinthe/construct_a_maze.pdf
-    */
-    if (frontierX != spanningTreeCellX) {
-        if (frontierX > spanningTreeCellX) {
-            matrix[frontierX][frontierY] = matrix[frontierX][frontierY] + 8; // suma 8 a la frontera
-            matrix[spanningTreeCellX][spanningTreeCellY] = matrix[spanningTreeCellX][spanningTreeCellY] + 2; // suma dos al spanning del q pertence la frontera
-        } else {
-            matrix[frontierX][frontierY] = matrix[frontierX][frontierY] + 2;
-            matrix[spanningTreeCellX][spanningTreeCellY] = matrix[spanningTreeCellX][spanningTreeCellY] + 8;
-        }
-    } else {
-        if (frontierY > spanningTreeCellY) {
-            matrix[frontierX][frontierY] = matrix[frontierX][frontierY] + 4;
-            matrix[spanningTreeCellX][spanningTreeCellY] = matrix[spanningTreeCellX][spanningTreeCellY] + 1;
-        } else {
-            matrix[frontierX][frontierY] = matrix[frontierX][frontierY] + 1;
-            matrix[spanningTreeCellX][spanningTreeCellY] = matrix[spanningTreeCellX][spanningTreeCellY] + 4;
-        }
-    }
-}
-// choose random position y le pone valor de 16
-void stepOne(int **matrix, int rows, int columns, int *positionX, int* positionY, int *frontierCellsXPosition, int *frontierCellsYPosition, int *frotierCellsArraySize) {
-    /*
-    Subroutine that executes the step one of the algorithm
-    Inputs and constraints:
-        -matrix: A pointer to a pointer of integers which represents a 2-dimensional array.
-        -rows: The number of rows in the matrix.
-        -columns: The number of columns in the matrix.
-        -positionX: The x position of a randomly selected starting cell.
-        -positionY: The y position of a randomly selected starting cell.
-        -frontierCellsXPosition: Stores the x position of the frontier cell.
-        -frontierCellsYPosition: Stores the y position of the frontier cell.
-        -frotierCellsArraySize: A pointer to the number of frontier cells.
-    Outputs:
-        -The complete execution of the step one
-    References:
-	-Matuszek, D. (n.d.). How to build a maze. Retrieved from https://www-fourier.ujf-grenoble.fr/~faure/enseignement/projets_simulation/labyrinthe/construct_a_maze.pdf
-    */
-
-    int randomXPosition = rand() % rows;
-    int randomYPosition = rand() % columns;
-
-    matrix[randomXPosition][randomYPosition] = initialCellStarterValue;
-    *positionX = randomXPosition;
-    *positionY = randomYPosition;
-
-    adjacentCellsIntoFrotierCells(matrix, rows, columns, randomXPosition, randomYPosition, frontierCellsXPosition, frontierCellsYPosition, frotierCellsArraySize);
-}
-
-void stepTwoAndThree(int **matrix, int rows, int columns, int *frontierCellsXPosition, int *frontierCellsYPosition, int *frotierCellsArraySize) { // Step Two and Three of the algorithm
-    /*
-    Subroutine that executes the steps two and three of the algorithm.
-    Inputs and constraints:
-        -matrix: A pointer to a pointer of integers which represents a 2-dimensional array.
-        -rows: The number of rows in the matrix.
-        -columns: The number of columns in the matrix.
-        -frontierCellsXPosition: Stores the x position of the frontier cell.
-        -frontierCellsYPosition: Stores the y position of the frontier cell.
-        -frotierCellsArraySize: A pointer to the number of frontier cells.
-    Outputs:
-        -The complete execution of the steps two and three.
-    References:
-	-Matuszek, D. (n.d.). How to build a maze. Retrieved from https://www-fourier.ujf-grenoble.fr/~faure/enseignement/projets_simulation/labyrinthe/construct_a_maze.pdf
-    */
-    int randomFrontierCellX, randomFrotierCellY;
-    searchRandomFrontierCell(&randomFrontierCellX, &randomFrotierCellY, frontierCellsXPosition, frontierCellsYPosition, frotierCellsArraySize);
-    int randomSpanningTreeCellX, randomSpanningTreeCellY;
-     //printf("search Random FrontierCell\n");
-     //printLaberynth(matrix, rows, columns);
-     //    printf("\n");
-
-    searchRandomSpanningTreeCell(matrix, rows, columns, randomFrontierCellX, randomFrotierCellY, &randomSpanningTreeCellX, &randomSpanningTreeCellY);
-    matrix[randomFrontierCellX][randomFrotierCellY] = 0;
-     //printf("search Random Spanning TreeCell\n");
-     //printLaberynth(matrix, rows, columns);
-        // printf("\n");
-
-    removeBarrierCell(matrix, randomFrontierCellX, randomFrotierCellY, randomSpanningTreeCellX, randomSpanningTreeCellY);
- //printf("Remove Barrier Cell\n");
-    // printLaberynth(matrix, rows, columns);
-      //   printf("\n");
-
-    adjacentCellsIntoFrotierCells(matrix, rows, columns, randomFrontierCellX, randomFrotierCellY, frontierCellsXPosition, frontierCellsYPosition, frotierCellsArraySize);
-   // printf("Adjacent\n");
-     //printLaberynth(matrix, rows, columns);
-      //   printf("\n");
-            
-    //printf("Otra vuelta ******************************************** \n\n");
-}
-
-bool stepFour(int frotierCellsArraySize) {
-    /*
-    Subroutine that executes the step four of the algorithm.
-    Inputs and constraints:
-        -frotierCellsArraySize: The number of frontier cells.
-    Outputs:
-        -The complete execution of the step four.
-    References:
-	-Matuszek, D. (n.d.). How to build a maze. Retrieved from https://www-fourier.ujf-grenoble.fr/~faure/enseignement/projets_simulation/labyrinthe/construct_a_maze.pdf
-    */
-    return frotierCellsArraySize > 0;
-}
-
-void stepFive(int **matrix, int rows, int columns, int initialCellXPosition, int initialCellYPosition) {
-    /*
-    Subroutine that executes the step five of the algorithm.
-    Inputs and constraints:
-        -matrix: A pointer to a pointer of integers which represents a 2-dimensional array.
-        -rows: The number of rows in the matrix.
-        -columns: The number of columns in the matrix.
-        -initialCellXPosition: Stores the x position of the initial cell.
-        -initialCellYPosition: Stores the y position of the initial cell.
-    Outputs:
-        -The complete execution of the step five.
-    References:
-	-Matuszek, D. (n.d.). How to build a maze. Retrieved from https://www-fourier.ujf-grenoble.fr/~faure/enseignement/projets_simulation/labyrinthe/construct_a_maze.pdf
-    */
-    matrix[0][0] = matrix[0][0] + 8;
-    matrix[rows - 1][columns - 1] = matrix[rows - 1][columns - 1] + 2;
-    matrix[initialCellXPosition][initialCellYPosition] = matrix[initialCellXPosition][initialCellYPosition] - initialCellStarterValue;
-}
-
-
-/*******************************Laberynth Main Functions*******************************/
-
-int** createLaberynth(int rows, int columns) {
-    /*
-    Subroutine that is in charge of creating the laberynth and storing it in a matrix.
-    Inputs and constraints:
-        -rows: The number of rows in the matrix.
-        -columns: The number of columns in the matrix.
-    Outputs:
-        -The matrix containing the values of the laberynth.
-    References:
-	-Matuszek, D. (n.d.). How to build a maze. Retrieved from https://www-fourier.ujf-grenoble.fr/~faure/enseignement/projets_simulation/labyrinthe/construct_a_maze.pdf
-    */
-
-    int **matrix = createMatrix(rows, columns);
-    srand(time(NULL));
-
-    int initialCellXPosition;
-    int initialCellYPosition;
-
-    int frontierCellsArrayMaxSize = 3 * (rows + columns);
-    int frontierCellsXPosition[frontierCellsArrayMaxSize];
-    int frontierCellsYPosition[frontierCellsArrayMaxSize];
-    int frontierCellsArraySize = 0;
-
-
-    stepOne(matrix, rows, columns, &initialCellXPosition, &initialCellYPosition, frontierCellsXPosition, frontierCellsYPosition, &frontierCellsArraySize);
-    
-    //printLaberynth(matrix, rows, columns);
-       //  printf("\n");
-    while (stepFour(frontierCellsArraySize))
-        stepTwoAndThree(matrix, rows, columns, frontierCellsXPosition, frontierCellsYPosition, &frontierCellsArraySize);
-    stepFive(matrix, rows, columns, initialCellXPosition, initialCellYPosition);
-
-    return matrix;
-}
-
-
-
-/*******************************Project - 2*******************************/
-
-/*
-
-comprueban si la dirección correspondiente está bloqueada o no por una pared, 
-y devuelve verdadero si la dirección no está bloqueada.
-
-*/
-
-// recibe un valor como 14 busca en la tabla y hace un AND si me da cero, devuelve true y no tiene ese borde
-bool canGoUp(int positionValue) { 
-   
-    bool res = !(borders[positionValue] & topBorder);
-
-    return res;
-}
-
-bool canGoDown(int positionValue) {
-    return !(borders[positionValue] & bottomBorder);
-}
-
-bool canGoRight(int positionValue) {
-    return !(borders[positionValue] & rightBorder);
-}
-
-bool canGoLeft(int positionValue) {
-    return !(borders[positionValue] & leftBorder);
-}
-
-/*******************************Random Mouse*******************************/ 
-void newRandomPosition(int **matrix, int rows, int columns, int currentPositionX, int currentPositionY, int *newPositionX, int *newPositionY) {
-    bool flag = true;
-    while (flag) {
-        switch (rand() % 4) {
-        case 0: // el % 16 es para asegurarse que no se salga del rango de indices de la tabla
-            if (currentPositionX - 1 >= 0 && canGoUp(matrix[currentPositionX][currentPositionY] % 16)) { // Up
-                *newPositionX -= 1;
-                 // printf("newPositionX en newRandomPosition: %d\n", newPositionX);
-        // printf("currentPositionY antes newRandom: %d\n", currentPositionY);
-                flag = false;
-            }
-            break;
-        case 1:
-            if (currentPositionX + 1 < rows && canGoDown(matrix[currentPositionX ][currentPositionY] % 16)) {
-                *newPositionX += 1;
-                //printf("newPositionX en newRandomPosition: %d\n", newPositionX);
-                flag = false;
-            }
-            break;
-        case 2:
-            if (currentPositionY - 1 >= 0 && canGoLeft(matrix[currentPositionX][currentPositionY] % 16)) {
-                *newPositionY -= 1;
-                //printf("newPositionY en newRandomPosition: %d\n", newPositionY);
-                flag = false;
-            }
-            break;
-        case 3:
-            if (currentPositionY + 1 < columns && canGoRight(matrix[currentPositionX][currentPositionY] % 16)) {
-                *newPositionY += 1;
-                //printf("newPositionY en newRandomPosition: %d\n", newPositionY);
-                flag = false;
-            }
-            break;
-        }
-    }
-}
-
-void randomMouse(int **matrix, int rows, int columns) {
-    // Start and End values
-    int laberynthEntranceX = 0; 
-    int laberynthEntranceY = 0;
-    int laberynthExitX = rows - 1;
-    int laberynthExitY = columns - 1;
-
-    // Algorithm
-    int currentPositionX = laberynthEntranceX;
-    int currentPositionY = laberynthEntranceY;
-    int newPositionX = currentPositionX;
-    int newPositionY = currentPositionY;
-
-    // Assign First Position as visited
-    matrix[currentPositionX][currentPositionY] = matrix[currentPositionX][currentPositionY] + 16;
-
-    int totalCycles = 0;
-    while(currentPositionX != laberynthExitX || currentPositionY != laberynthExitY) {
-        // Select a random new Position
-       // printf("currentPositionX antes newRandom: %d\n", currentPositionX);
-        // printf("currentPositionY antes newRandom: %d\n", currentPositionY);
-        //   printf("-----------------------------------------\n");
-        newRandomPosition(matrix, rows, columns, currentPositionX, currentPositionY, &newPositionX, &newPositionY);
-
-        // Set the values of the spot
-        if (matrix[newPositionX][newPositionY] > 15) {
-            matrix[currentPositionX][currentPositionY] = matrix[currentPositionX][currentPositionY] - 16;
-        } else {
-            matrix[newPositionX][newPositionY] = matrix[newPositionX][newPositionY] + 16;
-        }
-
-        //Assign values
-        currentPositionX = newPositionX;
-        currentPositionY = newPositionY;
-        totalCycles++;
-    }
-    printf("Total Cycles: %d\n", totalCycles);
-}
-
-/*******************************Right Hand Rule*******************************/
-void rightHandRule(int **matrix, int rows, int columns){}
-
-/*******************************Left Hand Rule*******************************/
-void leftHandRule(int **matrix, int rows, int columns) {}
-
-void PledgeAlgorithm(int **matrix, int rows, int columns) {}
-
-
-void tremaux(int **matrix, int rows, int columns)
-{
-    // Start and End values
-    int laberynthEntranceX = 0;
-    int laberynthEntranceY = 0;
-    int laberynthExitX = rows - 1;
-    int laberynthExitY = columns - 1;
-
-    // Algorithm
-    int currentPositionX = laberynthEntranceX;
-    int currentPositionY = laberynthEntranceY;
-    int newPositionX = currentPositionX;
-    int newPositionY = currentPositionY;
-    int previousPositionX = currentPositionX;
-    int previousPositionY = currentPositionY;
-
-    bool moved = false;
-    bool visitedTwice = false;
-
-    while ((currentPositionX != laberynthExitX) || (currentPositionY != laberynthExitY))
-    {
-        int value = matrix[currentPositionX][currentPositionY];
-        bool canGoUpp = canGoUp(value % 16);
-        bool canGoDownn = canGoDown(value % 16);
-        bool canGoLeftt = canGoLeft(value % 16);
-        bool canGoRightt = canGoRight(value % 16);
-
-        // Check if it can go up
-        if (currentPositionX - 1 > 0 && canGoUpp)
-        {
-            newPositionX = currentPositionX - 1;
-            int valueUp = matrix[newPositionX][currentPositionY];
-            if (valueUp < 16)
-            {
-
-                //printf("Up to %d \n", valueUp);
-                moved = true;
-                previousPositionX = currentPositionX;
-                previousPositionY = currentPositionY;
-                currentPositionX = newPositionX;
-                visitedTwice = false;
-            }
-            else
-            {
-                moved = false;
-                visitedTwice = true;
-            }
-        }
-
-        // Check if it can go down
-        if (!moved && currentPositionX + 1 < rows && canGoDownn)
-        {
-            newPositionX = currentPositionX + 1;
-            int valueDown = matrix[newPositionX][currentPositionY];
-            if (valueDown < 16)
-            {
-
-                printf("Down to %d \n", valueDown);
-                moved = true;
-                visitedTwice = false;
-                previousPositionX = currentPositionX;
-                previousPositionY = currentPositionY;
-                currentPositionX = newPositionX;
-            }
-            else
-            {
-                visitedTwice = true;
-                moved = false;
-            }
-        }
-
-        // Check if it can go left
-        if (!moved && currentPositionY - 1 > 0 && canGoLeftt)
-        {
-            newPositionY = currentPositionY - 1;
-            int valueLeft = matrix[currentPositionX][newPositionY];
-            if (valueLeft < 16)
-            {
-                currentPositionY = newPositionY;
-                printf("Left to %d \n", valueLeft);
-                moved = true;
-                visitedTwice = false;
-            }
-            else
-            {
-                visitedTwice = true;
-            }
-        }
-
-        // Check if it can go right
-        if (!moved && currentPositionY + 1 < columns)
-        {
-            newPositionY = currentPositionY + 1;
-            int valueRight = matrix[currentPositionX][newPositionY];
-            if (valueRight < 16)
-            {
-
-               printf("Right to %d \n", valueRight);
-                moved = true;
-                previousPositionX = currentPositionX;
-                previousPositionY = currentPositionY;
-                currentPositionY = newPositionY;
-                visitedTwice = false;
-            }
-            else
-            {
-                visitedTwice = true;
-            }
-        }
-
-        if (moved == true)
-        {
-
-            matrix[previousPositionX][previousPositionY] += 16;
-            printf("__________________\n");
-        }
-        else
-        {
-             printf( "___%d_______Visited ____%d____\n" , previousPositionX,previousPositionY);
-            currentPositionX = newPositionX;
-            currentPositionY = newPositionY;
-        }
-        moved = false;
-    }
-}
-//void TremauxAlgorithm(int **matrix, int rows, int columns) {}
-
-
-void FattahAlgorithm(int **matrix, int rows, int columns) {}
-
-/*******************************Main Program*******************************/
-
-int main() {
-    int rows = 5;
-    int columns = 5;
-    int **matrix = createLaberynth(rows, columns);
-
-    printLaberynth(matrix, rows, columns);
-
-    printf("- - - - - - - - - - - - - - - - - - - - - \n");
-
-     //randomMouse(matrix, rows, columns);
-      //printf("Random Mouse \n");
-    //printLaberynth(matrix, rows, columns);
-   printf("Solve Maze \n");
-   tremaux(matrix, rows, columns);
-
-   printf("- - - - - - - - - - - - - - - - - - - - - \n");
-   printLaberynth(matrix, rows, columns);
-
-    return 0;
-}
+#define _GNU_SOURCE // pthread_setaffinity_np and the cpu_set_t macros
+#include <stdlib.h>
+#include <stddef.h>
+#include <sys/types.h>
+#include <signal.h>
+#include <unistd.h>
+#include <math.h>
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <linux/perf_event.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+
+/*******************************Look Up Table Matrix Functions*******************************/
+/* Look Up Table
+    The creation of this look up table utilices the following reference:
+Jones, N. (2010, January 11). A tutorial on lookup tables in C «  Stack Overflow. https://embeddedgurus.com/stack-overflow/2010/01/a-tutorial-on-lookup-tables-in-c/
+*/
+
+/*******************************Principal Algorithm*******************************/
+/*Rules
+// -1 ; Frontier Cells
+// 0 ; Spanning Tree Cells
+// + 1 ; Right
+// + 2 ; Below
+// + 4 ; Left
+// + 8 ; Above
+RULES*/
+
+/*Situations
+0 ; All borders
+1 ; No right border
+2 ; No below border
+3 ; No right, below border
+4 ; No left border
+5 ; No left, right border
+6 ; No left, below border
+7 ; No right, below, left border
+8 ; No upper border
+9 ; No upper, right border
+10 ; No upper, below border
+11 ; No above, below, right border
+12 ; No left, upper border
+13 ; No left, upper, right border
+14 ; No above, left, below
+15 ; No borders
+Situations*/
+
+#define topBorder    1
+#define rightBorder  2
+#define bottomBorder 4
+#define leftBorder   8
+
+const int borders[] = {
+    topBorder | rightBorder | bottomBorder | leftBorder, // 15
+    topBorder | bottomBorder | leftBorder, // 13
+    topBorder | rightBorder | leftBorder,  // 11
+    topBorder | leftBorder, // 9
+    topBorder | rightBorder | bottomBorder, // 7
+    topBorder | bottomBorder, // 5
+    topBorder | rightBorder, // 3
+    topBorder, // 1
+    rightBorder | bottomBorder | leftBorder, // 14
+    bottomBorder | leftBorder, // 12
+    rightBorder | leftBorder, // 10
+    leftBorder, // 8
+    bottomBorder | rightBorder, // 6
+    bottomBorder, // 4
+    rightBorder, // 2
+    0
+};
+
+/*******************************Large Allocations*******************************/
+/*
+The cells of big laberynths take several GB, and the random moves of the solvers jump between pages, so most of
+their time can go to TLB misses. A block can be given huge pages, explicit (MAP_HUGETLB, needs pages reserved in
+/proc/sys/vm/nr_hugepages) or transparent (madvise MADV_HUGEPAGE), and its pages can be touched first by threads
+pinned to the NUMA nodes, one strip of rows per thread (matrixStripRows rows each), and strip i goes to node
+i % nodes (allocationNodeOfStrip). A consumer only gets local memory if it splits the rows and pins its threads
+the same way; validateLaberynth does, when it runs with as many threads as touched the matrix (the header of the
+block keeps them, largeBlockTouchThreads).
+Normal pages are asked for explicitly (madvise MADV_NOHUGEPAGE), so with transparent huge pages set to always
+they still are a baseline; without options a block is a plain malloc and gets whatever the system gives.
+Every block starts with an AllocationHeader placed right before the pointer returned, so releaseLargeBlock knows
+how it was allocated.
+*/
+
+#define normalPages            0
+#define transparentHugePages   1
+#define explicitHugePages      2
+#define hugePageBytes (2UL << 20)
+#define maxNumaNodes 64
+
+typedef struct {
+    int pages;        // normalPages, transparentHugePages or explicitHugePages
+    int touchThreads; // Threads that touch the strips of rows first, 0 touches with the calling thread
+} AllocationOptions;
+
+typedef struct {
+    void *mapping;    // Start of the malloc or mmap block
+    size_t mappingBytes;
+    int pages;        // Pages really obtained, explicit huge pages fall back to transparent ones
+    int mapped;
+    int touchThreads; // Threads that touched the strips first, 0 if the calling thread touched the whole block
+} AllocationHeader;
+
+int numaNodeCount = -1;
+cpu_set_t numaNodeCpus[maxNumaNodes];
+
+int parseCpuList(const char *list, cpu_set_t *cpus) {
+    /*
+    Subroutine that reads a list of processors like "0-3,8,10-11" as written in /sys/devices/system/node.
+    Outputs:
+        -Number of processors in the list.
+    */
+    CPU_ZERO(cpus);
+    int count = 0;
+    while (*list != '\0' && *list != '\n') {
+        char *end;
+        long first = strtol(list, &end, 10);
+        if (end == list)
+            break;
+        long last = first;
+        if (*end == '-')
+            last = strtol(end + 1, &end, 10);
+        for (long cpu = first; cpu <= last && cpu < CPU_SETSIZE; cpu++, count++)
+            CPU_SET(cpu, cpus);
+        list = *end == ',' ? end + 1 : end;
+    }
+    return count;
+}
+
+int numaNodes(void) {
+    /*
+    Subroutine that reads the NUMA nodes with processors the first time it is called.
+    Outputs:
+        -Number of nodes, 1 when the system does not show them (no pinning is done then).
+    */
+    if (numaNodeCount >= 0)
+        return numaNodeCount > 0 ? numaNodeCount : 1;
+    numaNodeCount = 0;
+    for (int node = 0; node < maxNumaNodes; node++) {
+        char path[64];
+        char list[1024];
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+        FILE *file = fopen(path, "r");
+        if (file == NULL)
+            break;
+        bool read = fgets(list, sizeof(list), file) != NULL;
+        fclose(file);
+        if (!read || parseCpuList(list, &numaNodeCpus[numaNodeCount]) == 0)
+            break;
+        numaNodeCount++;
+    }
+    return numaNodeCount > 0 ? numaNodeCount : 1;
+}
+
+int matrixStripRows(int rows, int strips) {
+    /*
+    Subroutine that gives the rows of every strip when a matrix is split in strips, the last strip can be
+    shorter and there are only (rows + stripRows - 1) / stripRows strips. Used by the first touch of
+    createMatrixWithOptions and by the threads that process the matrix, so both see the same strips.
+    */
+    if (strips <= 0)
+        strips = 1;
+    return rows > 0 ? (rows + strips - 1) / strips : 1;
+}
+
+int allocationNodeOfStrip(int strip) {
+    /*
+    Subroutine that gives the NUMA node whose memory holds a strip of a block touched by threads.
+    */
+    return strip % numaNodes();
+}
+
+bool pinThreadToNode(int node) {
+    /*
+    Subroutine that lets the calling thread run only on the processors of a NUMA node.
+    */
+    if (numaNodes() <= 1 || numaNodeCount == 0)
+        return false;
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &numaNodeCpus[node % numaNodeCount]) == 0;
+}
+
+typedef struct {
+    unsigned char *data;
+    size_t bytes;
+    int strip;
+    size_t stripBytes;
+} FirstTouchJob;
+
+void *firstTouchThread(void *argument) {
+    FirstTouchJob *job = argument;
+    pinThreadToNode(allocationNodeOfStrip(job->strip));
+    size_t first = job->stripBytes * job->strip;
+    size_t last = first + job->stripBytes < job->bytes ? first + job->stripBytes : job->bytes;
+    if (first < last)
+        memset(job->data + first, 0, last - first);
+    return NULL;
+}
+
+void *allocateLargeBlock(size_t bytes, size_t stripBytes, const AllocationOptions *options) {
+    /*
+    Subroutine that allocates a zeroed block, with huge pages and NUMA first touch if the options ask for them.
+    Inputs and constraints:
+        -bytes: Size of the block.
+        -stripBytes: Size of the strips given to each touching thread (rows of a strip times the bytes of a row),
+        0 splits the block in equal strips.
+        -options: How to allocate, NULL for a plain malloc (the pages the system gives).
+    Outputs:
+        -The block, released with releaseLargeBlock, or NULL if there is no memory.
+    References:
+        -Linux kernel documentation. Transparent Hugepage Support. https://www.kernel.org/doc/html/latest/admin-guide/mm/transhuge.html
+    */
+    size_t headerBytes = (sizeof(AllocationHeader) + 63) & ~(size_t) 63;
+    AllocationHeader header = {NULL, 0, normalPages, 0, 0};
+    unsigned char *data;
+
+    if (options == NULL) {
+        header.mapping = malloc(headerBytes + bytes);
+        if (header.mapping == NULL)
+            return NULL;
+        data = (unsigned char *) header.mapping + headerBytes;
+        memset(data, 0, bytes);
+    } else {
+        // The data starts at a huge page boundary and the header sits in the page before it
+        header.mappingBytes = ((bytes + hugePageBytes - 1) & ~(hugePageBytes - 1)) + hugePageBytes;
+        header.mapped = 1;
+        header.mapping = MAP_FAILED;
+        if (options->pages == explicitHugePages) {
+            header.mapping = mmap(NULL, header.mappingBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            header.pages = explicitHugePages;
+        }
+        if (header.mapping == MAP_FAILED) {
+            header.mappingBytes += hugePageBytes; // Room to align a normal mapping
+            header.mapping = mmap(NULL, header.mappingBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (header.mapping == MAP_FAILED)
+                return NULL;
+            header.pages = normalPages;
+        }
+        data = (unsigned char *) (((unsigned long) header.mapping + headerBytes + hugePageBytes - 1) & ~(hugePageBytes - 1));
+        size_t dataBytes = (bytes + hugePageBytes - 1) & ~(hugePageBytes - 1);
+        if (options->pages == normalPages)
+            madvise(data, dataBytes, MADV_NOHUGEPAGE);
+        else if (header.pages != explicitHugePages && madvise(data, dataBytes, MADV_HUGEPAGE) == 0)
+            header.pages = transparentHugePages;
+
+        // First touch: the pages of every strip are placed in the node of the thread that writes them first
+        if (options->touchThreads <= 0) {
+            memset(data, 0, bytes);
+        } else {
+            if (stripBytes == 0)
+                stripBytes = (bytes + options->touchThreads - 1) / options->touchThreads;
+            int strips = (int) ((bytes + stripBytes - 1) / stripBytes);
+            FirstTouchJob *jobs = malloc(sizeof(FirstTouchJob) * strips);
+            pthread_t *threads = malloc(sizeof(pthread_t) * options->touchThreads);
+            bool *started = malloc(sizeof(bool) * options->touchThreads);
+            header.touchThreads = options->touchThreads;
+            if (jobs == NULL || threads == NULL || started == NULL) { // Touched by the calling thread
+                memset(data, 0, bytes);
+                strips = 0;
+                header.touchThreads = 0;
+            }
+            for (int firstStrip = 0; firstStrip < strips; firstStrip += options->touchThreads) {
+                int batch = strips - firstStrip < options->touchThreads ? strips - firstStrip : options->touchThreads;
+                for (int thread = 0; thread < batch; thread++) {
+                    jobs[firstStrip + thread] = (FirstTouchJob) {data, bytes, firstStrip + thread, stripBytes};
+                    started[thread] = pthread_create(&threads[thread], NULL, firstTouchThread, &jobs[firstStrip + thread]) == 0;
+                    if (!started[thread]) // Zeroed anyway, in the node of the calling thread
+                        memset(data + stripBytes * (firstStrip + thread), 0,
+                               stripBytes < bytes - stripBytes * (firstStrip + thread) ? stripBytes : bytes - stripBytes * (firstStrip + thread));
+                }
+                for (int thread = 0; thread < batch; thread++) {
+                    if (started[thread])
+                        pthread_join(threads[thread], NULL);
+                }
+            }
+            free(started);
+            free(threads);
+            free(jobs);
+        }
+    }
+    memcpy(data - sizeof(AllocationHeader), &header, sizeof(AllocationHeader));
+    return data;
+}
+
+int largeBlockPages(const void *block) {
+    /*
+    Subroutine that tells which pages a block really got.
+    */
+    AllocationHeader header;
+    memcpy(&header, (const unsigned char *) block - sizeof(AllocationHeader), sizeof(AllocationHeader));
+    return header.pages;
+}
+
+int largeBlockTouchThreads(const void *block) {
+    /*
+    Subroutine that tells how many threads touched the strips of a block first, 0 if it was not touched by threads.
+    */
+    AllocationHeader header;
+    memcpy(&header, (const unsigned char *) block - sizeof(AllocationHeader), sizeof(AllocationHeader));
+    return header.touchThreads;
+}
+
+void releaseLargeBlock(void *block) {
+    if (block == NULL)
+        return;
+    AllocationHeader header;
+    memcpy(&header, (unsigned char *) block - sizeof(AllocationHeader), sizeof(AllocationHeader));
+    if (header.mapped)
+        munmap(header.mapping, header.mappingBytes);
+    else
+        free(header.mapping);
+}
+
+/*******************************General Matrix Functions*******************************/
+
+void fillMatrix(int **matrix, int rows, int columns, int value) {
+    /*
+    Subroutine that fills the array with equal values.
+    Inputs and constraints:
+        -matrix: Pointer to the matrix made up of integers to be filled with value.
+        -rows: Non-negative integer indicating the number of rows in the matrix.
+        -columns: Non-negative integer indicating the number of columns in the matrix.
+        -value: The value with which all the fields of the matrix will be filled.
+        Outputs:
+    -The matrix with all its fields with the value received by parameter.
+    */
+    for (int row = 0; row < rows; row++) {
+        for (int column = 0; column < columns; column++) {
+            matrix[row][column] = value;
+        }
+    }
+}
+
+int **createMatrixWithOptions(int rows, int columns, const AllocationOptions *options) {
+    /*
+    Subroutine that creates a matrix like createMatrix, with the allocation options of its cells block.
+    Inputs and constraints:
+        -rows, columns: Size of the matrix.
+        -options: Huge pages and NUMA first touch of the cells, NULL for createMatrix. With touch threads every
+        thread gets a strip of matrixStripRows rows.
+    Outputs:
+        -The matrix filled with zeros, released with freeMatrix, or NULL if there is no memory.
+    */
+    int **matrix = malloc(sizeof(int *) * rows);
+    if (matrix == NULL)
+        return NULL;
+    size_t rowBytes = sizeof(int) * (size_t) columns;
+    size_t stripBytes = 0;
+    if (options != NULL && options->touchThreads > 0)
+        stripBytes = rowBytes * matrixStripRows(rows, options->touchThreads);
+    int *cells = allocateLargeBlock(rowBytes * rows, stripBytes, options);
+    if (cells == NULL) {
+        free(matrix);
+        return NULL;
+    }
+
+    for (int row = 0; row < rows; row++) {
+        matrix[row] = cells + (size_t) row * columns;
+    }
+    return matrix;
+}
+
+int **createMatrix(int rows, int columns) { //
+
+    /*
+    Subroutine that is in charge of creating an array from its number of rows and columns.
+    Inputs and constraints:
+        -rows: Non-negative integer indicating the number of rows in the matrix.
+        -columns: Non-negative integer indicating the number of columns in the matrix.
+    Outputs:
+    -The correctly created matrix. All the rows live in one contiguous block starting at matrix[0], so
+    matrix[0] can also be used as a row major array of rows * columns cells.
+    References:
+        -Portfolio Courses. (2022a, September 2). Return A Dynamically Allocated 2D Array From A Function | C Programming Tutorial [Video]. YouTube. https://www.youtube.com/watch?v=22wkCgsPZSU
+    */
+
+    return createMatrixWithOptions(rows, columns, NULL);
+}
+
+void freeMatrix(int **matrix, int rows) {
+   /*
+    Subroutine that returns the memory occupied by a matrix created by createMatrix.
+    Inputs and constraints:
+        -matrix: Pointer to the matrix that will free its memory.
+        -rows: Non-negative integer indicating the number of rows in the matrix.
+    Outputs:
+        -Memory occupied by the correctly freed matrix.
+    */
+    if (rows > 0) {
+        releaseLargeBlock(matrix[0]); // Block with every row
+    }
+    free(matrix);
+}
+
+int initialCellStarterValue = 16;
+
+
+void printLaberynth(int **matrix, int rows, int columns) {
+    for (int i = 0; i < rows; i++) {
+        printf("[ ");
+        for (int z = 0; z < columns; z++) {
+            printf("%d, ", matrix[i][z]);
+        }
+        printf("]\n");
+    }
+
+}
+void adjacentCellsIntoFrotierCells(int **matrix, int rows, int columns, int positionX, int positionY, int *frontierCellsXPosition, int *frontierCellsYPosition, int *frotierCellsArraySize) {
+    /*
+    Subroutine that converts the adjacent cells of a given position in a matrix into frontier cells.
+    Inputs and constraints:
+        - matrix: A pointer to a two-dimensional array of integers representing the matrix.
+        - rows: The number of rows in the matrix.
+        - columns: The number of columns in the matrix.
+        - positionX: The X-coordinate of the position in the matrix whose adjacent cells to convert. coor x spanning
+        - positionY: The Y-coordinate of the position in the matrix whose adjacent cells to convert. coor y del spanning
+        - frontierCellsXPosition: A pointer to an array of integers to store the X-coordinates of the resulting frontier cells. guardo coord x en array
+        - frontierCellsYPosition: A pointer to an array of integers to store the Y-coordinates of the resulting frontier cells.  guardo coord y en array
+        - frotierCellsArraySize: A pointer to an integer to store the size of the resulting frontier cells array.
+    Outputs:
+        -The adjacent cell of the given position in the matrix into a frontier cell.
+    References:
+	-Matuszek, D. (n.d.). How to build a maze. Retrieved from https://www-fourier.ujf-grenoble.fr/~faure/enseignement/projets_simulation/labyrinthe/construct_a_maze.pdf
+ */    
+
+    if (positionX - 1 >= 0 && matrix[positionX - 1][positionY] == 0) { // Up
+        matrix[positionX - 1][positionY] = -1;
+        frontierCellsXPosition[*frotierCellsArraySize] = positionX - 1;
+        frontierCellsYPosition[*frotierCellsArraySize] = positionY;
+        *frotierCellsArraySize = *frotierCellsArraySize + 1;
+    }
+
+    if (positionX + 1 < rows && matrix[positionX + 1][positionY] == 0) { // Down
+        matrix[positionX + 1][positionY] = -1;
+        frontierCellsXPosition[*frotierCellsArraySize] = positionX + 1;
+        frontierCellsYPosition[*frotierCellsArraySize] = positionY;
+        *frotierCellsArraySize = *frotierCellsArraySize + 1;
+    }
+
+    if (positionY - 1 >= 0 && matrix[positionX][positionY - 1] == 0) { // Left
+        matrix[positionX][positionY - 1] = -1;
+        frontierCellsXPosition[*frotierCellsArraySize] = positionX;
+        frontierCellsYPosition[*frotierCellsArraySize] = positionY - 1;
+        *frotierCellsArraySize = *frotierCellsArraySize + 1;
+    }
+
+    if (positionY + 1 < columns && matrix[positionX][positionY + 1] == 0) { // Right
+        matrix[positionX][positionY + 1] = -1;
+        frontierCellsXPosition[*frotierCellsArraySize] = positionX;
+        frontierCellsYPosition[*frotierCellsArraySize] = positionY + 1;
+        *frotierCellsArraySize = *frotierCellsArraySize + 1;
+    }
+}
+
+void searchRandomFrontierCell(int *positionX, int *positionY, int *frontierCellsXPosition, int *frontierCellsYPosition, int *frontierCellsArraySize) { // Searchs a random Frontier Cell
+    /*
+    Subroutine that is in charge of searching for a random border cell.
+    Inputs and constraints:
+        -positionX: Pointer to the X position of the selected cell.
+        -positionY: Pointer to the Y position of the selected cell.
+        -frontierCellsXPosition: Pointer to the array of X positions of the border cells.
+        -frontierCellsYPosition: Pointer to the array of Y positions of the border cells.
+        -positionY: Pointer to the Y position of the selected cell.
+        -frontierCellsArraySize: Pointer to the current size of the border cells array.
+    Outputs:
+        -The random frontier cell already selected.
+    References:
+	-Matuszek, D. (n.d.). How to build a maze. Retrieved from https://www-fourier.ujf-grenoble.fr/~faure/enseignement/projets_simulation/labyrinthe/construct_a_maze.pdf
+    */
+    int randomPosition = rand() % (*frontierCellsArraySize);
+    *positionX = frontierCellsXPosition[randomPosition];
+    *positionY = frontierCellsYPosition[randomPosition];
+    *frontierCellsArraySize = *frontierCellsArraySize - 1; // update size del array
+    // recorta el tamano del array
+    for (int i = randomPosition; i < *frontierCellsArraySize; i++) {
+        frontierCellsXPosition[i] = frontierCellsXPosition[i + 1];
+        frontierCellsYPosition[i] = frontierCellsYPosition[i + 1];
+    }
+}
+ 
+void searchRandomSpanningTreeCell(int **matrix, int rows, int columns, int positionX, int positionY, int *randomSpanningTreeCellX, int *randomSpanningTreeCellY) { // Search a random Spanning Tree Cell adjacent to a Frontier Cell
+    /*
+    Subroutine that searches for a random cell of the spanning tree adjacent to a boundary cell in a given array.
+        -matrix: The matrix to search in.
+        -rows: The number of rows in the matrix.
+        -columns: The number of columns in the matrix.
+        -positionX: The x-position of the boundary cell.
+        -positionY: The y position of the border cell.
+        -randomSpanningTreeCellX: pointer to a variable where the x position of the random cell of the spanning tree will be stored.
+        -randomSpanningTreeCellY: A pointer to a variable where the y-position of the random Spanning Tree Cell will be stored.
+    Outputs:
+        -randomSpanningTreeCell adjacent to a boundary cell in a given matrix.
+    References:
+	-Matuszek, D. (n.d.). How to build a maze. Retrieved from https://www-fourier.ujf-grenoble.fr/~faure/enseignement/projets_simulation/labyrinthe/construct_a_maze.pdf
+    */
+
+   // si no se ha salido del borde y no esta en spanning tree ya
+    *randomSpanningTreeCellX = positionX;
+    *randomSpanningTreeCellY = positionY;
+
+    bool flag = true;                                      // -1 -1 -1 -1 -1
+                                                           // -1  7
+
+    while (flag) {    // 1,1
+        switch (rand() % 4) {  // 0  1  mat[0][1]
+        case 0: // si le resto uno a mi fila y no me he salido del borde de arriba
+            if (positionX - 1 >= 0 && matrix[positionX - 1][positionY] > 0) { // Up
+                *randomSpanningTreeCellX -= 1;
+                flag = false;
+            }
+            break;
+        case 1:// si es ultima fila y no me he salido
+            if (positionX + 1 < rows && matrix[positionX + 1][positionY] > 0) {
+                *randomSpanningTreeCellX += 1;
+                flag = false;
+            }
+            break;
+        case 2:
+            if (positionY - 1 >= 0 && matrix[positionX][positionY - 1] > 0) {
+                *randomSpanningTreeCellY -= 1;
+                flag = false;
+            }
+            break;
+        case 3:
+            if (positionY + 1 < columns && matrix[positionX][positionY + 1] > 0) {
+                *randomSpanningTreeCellY += 1;
+                flag = false;
+            }
+            break;
+        }
+    }
+}
+
+void removeBarrierCell(int **matrix, int frontierX, int frontierY, int spanningTreeCellX, int spanningTreeCellY) { // Removes a barrier cell between two coordinates
+    /*
+    Subroutine that updates a matrix to remove a barrier cell between two coordinates. Checks the relative
+    positions of the two cells and update the matrix accordingly.
+    Inputs and constraints:
+        -array: A pointer to a 2D array of integers representing the matrix.
+        -frontierX: An integer representing the x-coordinate of the cell boundary.
+        -frontierY: An integer representing the y-coordinate of the boundary cell.
+        -spanningTreeCellX: An integer representing the x-coordinate of the spanning tree cell.
+        -spanningTreeCellY: An integer representing the y-coordinate of the spanning tree cell.
+    Outputs:
+        -The matrix with the barrier cell removed between the two coordinates.
+    References:
+	-Matuszek, D. (n.d.). How to build a maze. Retrieved from https://www-fourier.ujf-grenoble.fr/~faure/enseignement/projets_simulation/labyrinthe/construct_a_maze.pdf
+    */
+    if (frontierX != spanningTreeCellX) {
+        if (frontierX > spanningTreeCellX) {
+            matrix[frontierX][frontierY] = matrix[frontierX][frontierY] + 8; // suma 8 a la frontera
+            matrix[spanningTreeCellX][spanningTreeCellY] = matrix[spanningTreeCellX][spanningTreeCellY] + 2; // suma dos al spanning del q pertence la frontera
+        } else {
+            matrix[frontierX][frontierY] = matrix[frontierX][frontierY] + 2;
+            matrix[spanningTreeCellX][spanningTreeCellY] = matrix[spanningTreeCellX][spanningTreeCellY] + 8;
+        }
+    } else {
+        if (frontierY > spanningTreeCellY) {
+            matrix[frontierX][frontierY] = matrix[frontierX][frontierY] + 4;
+            matrix[spanningTreeCellX][spanningTreeCellY] = matrix[spanningTreeCellX][spanningTreeCellY] + 1;
+        } else {
+            matrix[frontierX][frontierY] = matrix[frontierX][frontierY] + 1;
+            matrix[spanningTreeCellX][spanningTreeCellY] = matrix[spanningTreeCellX][spanningTreeCellY] + 4;
+        }
+    }
+}
+// choose random position y le pone valor de 16
+void stepOne(int **matrix, int rows, int columns, int *positionX, int* positionY, int *frontierCellsXPosition, int *frontierCellsYPosition, int *frotierCellsArraySize) {
+    /*
+    Subroutine that executes the step one of the algorithm
+    Inputs and constraints:
+        -matrix: A pointer to a pointer of integers which represents a 2-dimensional array.
+        -rows: The number of rows in the matrix.
+        -columns: The number of columns in the matrix.
+        -positionX: The x position of a randomly selected starting cell.
+        -positionY: The y position of a randomly selected starting cell.
+        -frontierCellsXPosition: Stores the x position of the frontier cell.
+        -frontierCellsYPosition: Stores the y position of the frontier cell.
+        -frotierCellsArraySize: A pointer to the number of frontier cells.
+    Outputs:
+        -The complete execution of the step one
+    References:
+	-Matuszek, D. (n.d.). How to build a maze. Retrieved from https://www-fourier.ujf-grenoble.fr/~faure/enseignement/projets_simulation/labyrinthe/construct_a_maze.pdf
+    */
+
+    int randomXPosition = rand() % rows;
+    int randomYPosition = rand() % columns;
+
+    matrix[randomXPosition][randomYPosition] = initialCellStarterValue;
+    *positionX = randomXPosition;
+    *positionY = randomYPosition;
+
+    adjacentCellsIntoFrotierCells(matrix, rows, columns, randomXPosition, randomYPosition, frontierCellsXPosition, frontierCellsYPosition, frotierCellsArraySize);
+}
+
+void stepTwoAndThree(int **matrix, int rows, int columns, int *frontierCellsXPosition, int *frontierCellsYPosition, int *frotierCellsArraySize) { // Step Two and Three of the algorithm
+    /*
+    Subroutine that executes the steps two and three of the algorithm.
+    Inputs and constraints:
+        -matrix: A pointer to a pointer of integers which represents a 2-dimensional array.
+        -rows: The number of rows in the matrix.
+        -columns: The number of columns in the matrix.
+        -frontierCellsXPosition: Stores the x position of the frontier cell.
+        -frontierCellsYPosition: Stores the y position of the frontier cell.
+        -frotierCellsArraySize: A pointer to the number of frontier cells.
+    Outputs:
+        -The complete execution of the steps two and three.
+    References:
+	-Matuszek, D. (n.d.). How to build a maze. Retrieved from https://www-fourier.ujf-grenoble.fr/~faure/enseignement/projets_simulation/labyrinthe/construct_a_maze.pdf
+    */
+    int randomFrontierCellX, randomFrotierCellY;
+    searchRandomFrontierCell(&randomFrontierCellX, &randomFrotierCellY, frontierCellsXPosition, frontierCellsYPosition, frotierCellsArraySize);
+    int randomSpanningTreeCellX, randomSpanningTreeCellY;
+     //printf("search Random FrontierCell\n");
+     //printLaberynth(matrix, rows, columns);
+     //    printf("\n");
+
+    searchRandomSpanningTreeCell(matrix, rows, columns, randomFrontierCellX, randomFrotierCellY, &randomSpanningTreeCellX, &randomSpanningTreeCellY);
+    matrix[randomFrontierCellX][randomFrotierCellY] = 0;
+     //printf("search Random Spanning TreeCell\n");
+     //printLaberynth(matrix, rows, columns);
+        // printf("\n");
+
+    removeBarrierCell(matrix, randomFrontierCellX, randomFrotierCellY, randomSpanningTreeCellX, randomSpanningTreeCellY);
+ //printf("Remove Barrier Cell\n");
+    // printLaberynth(matrix, rows, columns);
+      //   printf("\n");
+
+    adjacentCellsIntoFrotierCells(matrix, rows, columns, randomFrontierCellX, randomFrotierCellY, frontierCellsXPosition, frontierCellsYPosition, frotierCellsArraySize);
+   // printf("Adjacent\n");
+     //printLaberynth(matrix, rows, columns);
+      //   printf("\n");
+            
+    //printf("Otra vuelta ******************************************** \n\n");
+}
+
+bool stepFour(int frotierCellsArraySize) {
+    /*
+    Subroutine that executes the step four of the algorithm.
+    Inputs and constraints:
+        -frotierCellsArraySize: The number of frontier cells.
+    Outputs:
+        -The complete execution of the step four.
+    References:
+	-Matuszek, D. (n.d.). How to build a maze. Retrieved from https://www-fourier.ujf-grenoble.fr/~faure/enseignement/projets_simulation/labyrinthe/construct_a_maze.pdf
+    */
+    return frotierCellsArraySize > 0;
+}
+
+void stepFive(int **matrix, int rows, int columns, int initialCellXPosition, int initialCellYPosition) {
+    /*
+    Subroutine that executes the step five of the algorithm.
+    Inputs and constraints:
+        -matrix: A pointer to a pointer of integers which represents a 2-dimensional array.
+        -rows: The number of rows in the matrix.
+        -columns: The number of columns in the matrix.
+        -initialCellXPosition: Stores the x position of the initial cell.
+        -initialCellYPosition: Stores the y position of the initial cell.
+    Outputs:
+        -The complete execution of the step five.
+    References:
+	-Matuszek, D. (n.d.). How to build a maze. Retrieved from https://www-fourier.ujf-grenoble.fr/~faure/enseignement/projets_simulation/labyrinthe/construct_a_maze.pdf
+    */
+    matrix[0][0] = matrix[0][0] + 8;
+    matrix[rows - 1][columns - 1] = matrix[rows - 1][columns - 1] + 2;
+    matrix[initialCellXPosition][initialCellYPosition] = matrix[initialCellXPosition][initialCellYPosition] - initialCellStarterValue;
+}
+
+
+/*******************************Laberynth Main Functions*******************************/
+
+int** createLaberynth(int rows, int columns) {
+    /*
+    Subroutine that is in charge of creating the laberynth and storing it in a matrix.
+    Inputs and constraints:
+        -rows: The number of rows in the matrix.
+        -columns: The number of columns in the matrix.
+    Outputs:
+        -The matrix containing the values of the laberynth.
+    References:
+	-Matuszek, D. (n.d.). How to build a maze. Retrieved from https://www-fourier.ujf-grenoble.fr/~faure/enseignement/projets_simulation/labyrinthe/construct_a_maze.pdf
+    */
+
+    int **matrix = createMatrix(rows, columns);
+    srand(time(NULL));
+
+    int initialCellXPosition;
+    int initialCellYPosition;
+
+    int frontierCellsArrayMaxSize = 3 * (rows + columns);
+    int frontierCellsXPosition[frontierCellsArrayMaxSize];
+    int frontierCellsYPosition[frontierCellsArrayMaxSize];
+    int frontierCellsArraySize = 0;
+
+
+    stepOne(matrix, rows, columns, &initialCellXPosition, &initialCellYPosition, frontierCellsXPosition, frontierCellsYPosition, &frontierCellsArraySize);
+    
+    //printLaberynth(matrix, rows, columns);
+       //  printf("\n");
+    while (stepFour(frontierCellsArraySize))
+        stepTwoAndThree(matrix, rows, columns, frontierCellsXPosition, frontierCellsYPosition, &frontierCellsArraySize);
+    stepFive(matrix, rows, columns, initialCellXPosition, initialCellYPosition);
+
+    return matrix;
+}
+
+
+
+/*******************************Project - 2*******************************/
+
+/*
+
+comprueban si la dirección correspondiente está bloqueada o no por una pared, 
+y devuelve verdadero si la dirección no está bloqueada.
+
+*/
+
+// recibe un valor como 14 busca en la tabla y hace un AND si me da cero, devuelve true y no tiene ese borde
+bool canGoUp(int positionValue) { 
+   
+    bool res = !(borders[positionValue] & topBorder);
+
+    return res;
+}
+
+bool canGoDown(int positionValue) {
+    return !(borders[positionValue] & bottomBorder);
+}
+
+bool canGoRight(int positionValue) {
+    return !(borders[positionValue] & rightBorder);
+}
+
+bool canGoLeft(int positionValue) {
+    return !(borders[positionValue] & leftBorder);
+}
+
+/*******************************Random Mouse*******************************/ 
+void newRandomPosition(int **matrix, int rows, int columns, int currentPositionX, int currentPositionY, int *newPositionX, int *newPositionY) {
+    bool flag = true;
+    while (flag) {
+        switch (rand() % 4) {
+        case 0: // el % 16 es para asegurarse que no se salga del rango de indices de la tabla
+            if (currentPositionX - 1 >= 0 && canGoUp(matrix[currentPositionX][currentPositionY] % 16)) { // Up
+                *newPositionX -= 1;
+                 // printf("newPositionX en newRandomPosition: %d\n", newPositionX);
+        // printf("currentPositionY antes newRandom: %d\n", currentPositionY);
+                flag = false;
+            }
+            break;
+        case 1:
+            if (currentPositionX + 1 < rows && canGoDown(matrix[currentPositionX ][currentPositionY] % 16)) {
+                *newPositionX += 1;
+                //printf("newPositionX en newRandomPosition: %d\n", newPositionX);
+                flag = false;
+            }
+            break;
+        case 2:
+            if (currentPositionY - 1 >= 0 && canGoLeft(matrix[currentPositionX][currentPositionY] % 16)) {
+                *newPositionY -= 1;
+                //printf("newPositionY en newRandomPosition: %d\n", newPositionY);
+                flag = false;
+            }
+            break;
+        case 3:
+            if (currentPositionY + 1 < columns && canGoRight(matrix[currentPositionX][currentPositionY] % 16)) {
+                *newPositionY += 1;
+                //printf("newPositionY en newRandomPosition: %d\n", newPositionY);
+                flag = false;
+            }
+            break;
+        }
+    }
+}
+
+void randomMouse(int **matrix, int rows, int columns) {
+    // Start and End values
+    int laberynthEntranceX = 0; 
+    int laberynthEntranceY = 0;
+    int laberynthExitX = rows - 1;
+    int laberynthExitY = columns - 1;
+
+    // Algorithm
+    int currentPositionX = laberynthEntranceX;
+    int currentPositionY = laberynthEntranceY;
+    int newPositionX = currentPositionX;
+    int newPositionY = currentPositionY;
+
+    // Assign First Position as visited
+    matrix[currentPositionX][currentPositionY] = matrix[currentPositionX][currentPositionY] + 16;
+
+    int totalCycles = 0;
+    while(currentPositionX != laberynthExitX || currentPositionY != laberynthExitY) {
+        // Select a random new Position
+       // printf("currentPositionX antes newRandom: %d\n", currentPositionX);
+        // printf("currentPositionY antes newRandom: %d\n", currentPositionY);
+        //   printf("-----------------------------------------\n");
+        newRandomPosition(matrix, rows, columns, currentPositionX, currentPositionY, &newPositionX, &newPositionY);
+
+        // Set the values of the spot
+        if (matrix[newPositionX][newPositionY] > 15) {
+            matrix[currentPositionX][currentPositionY] = matrix[currentPositionX][currentPositionY] - 16;
+        } else {
+            matrix[newPositionX][newPositionY] = matrix[newPositionX][newPositionY] + 16;
+        }
+
+        //Assign values
+        currentPositionX = newPositionX;
+        currentPositionY = newPositionY;
+        totalCycles++;
+    }
+    printf("Total Cycles: %d\n", totalCycles);
+}
+
+/*******************************Right Hand Rule*******************************/
+void rightHandRule(int **matrix, int rows, int columns){}
+
+/*******************************Left Hand Rule*******************************/
+void leftHandRule(int **matrix, int rows, int columns) {}
+
+void PledgeAlgorithm(int **matrix, int rows, int columns) {}
+
+
+void tremaux(int **matrix, int rows, int columns)
+{
+    // Start and End values
+    int laberynthEntranceX = 0;
+    int laberynthEntranceY = 0;
+    int laberynthExitX = rows - 1;
+    int laberynthExitY = columns - 1;
+
+    // Algorithm
+    int currentPositionX = laberynthEntranceX;
+    int currentPositionY = laberynthEntranceY;
+    int newPositionX = currentPositionX;
+    int newPositionY = currentPositionY;
+    int previousPositionX = currentPositionX;
+    int previousPositionY = currentPositionY;
+
+    bool moved = false;
+    bool visitedTwice = false;
+
+    while ((currentPositionX != laberynthExitX) || (currentPositionY != laberynthExitY))
+    {
+        int value = matrix[currentPositionX][currentPositionY];
+        bool canGoUpp = canGoUp(value % 16);
+        bool canGoDownn = canGoDown(value % 16);
+        bool canGoLeftt = canGoLeft(value % 16);
+        bool canGoRightt = canGoRight(value % 16);
+
+        // Check if it can go up
+        if (currentPositionX - 1 > 0 && canGoUpp)
+        {
+            newPositionX = currentPositionX - 1;
+            int valueUp = matrix[newPositionX][currentPositionY];
+            if (valueUp < 16)
+            {
+
+                //printf("Up to %d \n", valueUp);
+                moved = true;
+                previousPositionX = currentPositionX;
+                previousPositionY = currentPositionY;
+                currentPositionX = newPositionX;
+                visitedTwice = false;
+            }
+            else
+            {
+                moved = false;
+                visitedTwice = true;
+            }
+        }
+
+        // Check if it can go down
+        if (!moved && currentPositionX + 1 < rows && canGoDownn)
+        {
+            newPositionX = currentPositionX + 1;
+            int valueDown = matrix[newPositionX][currentPositionY];
+            if (valueDown < 16)
+            {
+
+                printf("Down to %d \n", valueDown);
+                moved = true;
+                visitedTwice = false;
+                previousPositionX = currentPositionX;
+                previousPositionY = currentPositionY;
+                currentPositionX = newPositionX;
+            }
+            else
+            {
+                visitedTwice = true;
+                moved = false;
+            }
+        }
+
+        // Check if it can go left
+        if (!moved && currentPositionY - 1 > 0 && canGoLeftt)
+        {
+            newPositionY = currentPositionY - 1;
+            int valueLeft = matrix[currentPositionX][newPositionY];
+            if (valueLeft < 16)
+            {
+                currentPositionY = newPositionY;
+                printf("Left to %d \n", valueLeft);
+                moved = true;
+                visitedTwice = false;
+            }
+            else
+            {
+                visitedTwice = true;
+            }
+        }
+
+        // Check if it can go right
+        if (!moved && currentPositionY + 1 < columns)
+        {
+            newPositionY = currentPositionY + 1;
+            int valueRight = matrix[currentPositionX][newPositionY];
+            if (valueRight < 16)
+            {
+
+               printf("Right to %d \n", valueRight);
+                moved = true;
+                previousPositionX = currentPositionX;
+                previousPositionY = currentPositionY;
+                currentPositionY = newPositionY;
+                visitedTwice = false;
+            }
+            else
+            {
+                visitedTwice = true;
+            }
+        }
+
+        if (moved == true)
+        {
+
+            matrix[previousPositionX][previousPositionY] += 16;
+            printf("__________________\n");
+        }
+        else
+        {
+             printf( "___%d_______Visited ____%d____\n" , previousPositionX,previousPositionY);
+            currentPositionX = newPositionX;
+            currentPositionY = newPositionY;
+        }
+        moved = false;
+    }
+}
+//void TremauxAlgorithm(int **matrix, int rows, int columns) {}
+
+
+void FattahAlgorithm(int **matrix, int rows, int columns) {}
+
+/*******************************Chunked Infinite Laberynth*******************************/
+/*
+The infinite laberynth is split in square chunks of chunkSize x chunkSize cells. A chunk is only generated
+the first time a solver touches one of its cells, and its contents come from a hash of (seed, chunk coordinates),
+so an evicted chunk can be generated again later with exactly the same walls.
+Every chunk is a perfect maze on its own and is joined to each of its four neighbors by one door. The door
+position of a shared border is hashed from the coordinates of the border, so both chunks open the same cell.
+Cell bytes of a chunk:
+// bits 0-3 ; Openings, same rules as the matrix (1 Right, 2 Below, 4 Left, 8 Above)
+// bit 4 ; Visited by a solver
+// bits 5-7 ; Tremaux direction back to the previous cell (0 none, 1 + direction)
+*/
+
+#define chunkShift 6
+#define chunkSize (1 << chunkShift)
+#define chunkMask (chunkSize - 1)
+#define chunkBucketCount 4096
+
+#define rightOpening 1
+#define belowOpening 2
+#define leftOpening  4
+#define aboveOpening 8
+
+// Directions in the same order used by newRandomPosition: Up, Down, Left, Right
+const int directionOpening[] = {aboveOpening, belowOpening, leftOpening, rightOpening};
+const int directionOppositeOpening[] = {belowOpening, aboveOpening, rightOpening, leftOpening};
+const int directionOpposite[] = {1, 0, 3, 2};
+const int directionRowStep[] = {-1, 1, 0, 0};
+const int directionColumnStep[] = {0, 0, -1, 1};
+
+unsigned long long mixBits(unsigned long long value) {
+    /*
+    Subroutine that scrambles the bits of a 64 bit value (splitmix64 finalizer).
+    Inputs and constraints:
+        -value: Any 64 bit value.
+    Outputs:
+        -A well distributed hash of the value.
+    References:
+        -Steele, G., Lea, D., & Flood, C. (2014). Fast splittable pseudorandom number generators. OOPSLA 2014.
+    */
+    value += 0x9E3779B97F4A7C15ULL;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+}
+
+unsigned long long hashCoordinates(unsigned long long seed, long long x, long long y, unsigned long long salt) {
+    /*
+    Subroutine that hashes a pair of coordinates together with a seed and a salt that tells apart different uses.
+    Inputs and constraints:
+        -seed: Seed of the laberynth.
+        -x, y: Coordinates to hash, they can be negative.
+        -salt: Small constant that identifies what the hash is used for.
+    Outputs:
+        -Deterministic 64 bit hash of the four values.
+    */
+    return mixBits(seed ^ mixBits((unsigned long long) x ^ mixBits((unsigned long long) y ^ mixBits(salt))));
+}
+
+unsigned int nextRandom(unsigned long long *state) {
+    /*
+    Subroutine that advances a xorshift64* generator. Unlike rand() its whole state is one number owned by the caller,
+    so the same seed always gives the same sequence.
+    Inputs and constraints:
+        -state: Pointer to the generator state, it must never be zero.
+    Outputs:
+        -32 random bits and the state advanced.
+    References:
+        -Vigna, S. (2016). An experimental exploration of Marsaglia's xorshift generators, scrambled. ACM TOMS 42(4).
+    */
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return (unsigned int) ((*state * 0x2545F4914F6CDD1DULL) >> 32);
+}
+
+unsigned long long seedRandom(unsigned long long seed) {
+    /*
+    Subroutine that turns any seed into a valid (non zero) xorshift state.
+    */
+    return mixBits(seed) | 1;
+}
+
+typedef struct Chunk {
+    long long chunkX;
+    long long chunkY;
+    unsigned char cells[chunkSize * chunkSize];
+    int markedCells; // Chunks with solver marks are never evicted
+    unsigned long long lastUse; // Value of the use clock in the last fetch
+    struct Chunk *next;
+    struct Chunk *newer; // Neighbors in the list of evictable chunks
+    struct Chunk *older;
+} Chunk;
+
+typedef struct {
+    unsigned long long seed;
+    int maxLoadedChunks;
+    int loadedChunks;
+    unsigned long long generatedChunks;
+    Chunk *lastChunk;
+    unsigned long long useClock;
+    Chunk *newestChunk; // List of the loaded chunks without marks, from the most to the least recently used
+    Chunk *oldestChunk;
+    Chunk *buckets[chunkBucketCount];
+} ChunkedLaberynth;
+
+int chunkBorderDoor(unsigned long long seed, long long chunkX, long long chunkY, int vertical) {
+    /*
+    Subroutine that gives the position of the door on the upper (vertical = 0) or left (vertical = 1) border of a chunk.
+    The chunk above (or on the left) asks for the same border, so both sides open the same cell.
+    */
+    return (int) (hashCoordinates(seed, chunkX, chunkY, 1 + vertical) & chunkMask);
+}
+
+void generateChunk(ChunkedLaberynth *maze, Chunk *chunk) {
+    /*
+    Subroutine that fills a chunk with a perfect maze using the same frontier cell algorithm as createLaberynth,
+    and then opens the four doors of its borders.
+    Inputs and constraints:
+        -maze: The chunked laberynth the chunk belongs to.
+        -chunk: Chunk with its coordinates already set.
+    Outputs:
+        -The cells of the chunk, identical every time the same chunk is generated.
+    References:
+        -Matuszek, D. (n.d.). How to build a maze. Retrieved from https://www-fourier.ujf-grenoble.fr/~faure/enseignement/projets_simulation/labyrinthe/construct_a_maze.pdf
+    */
+    unsigned long long randomState = seedRandom(hashCoordinates(maze->seed, chunk->chunkX, chunk->chunkY, 0));
+    signed char status[chunkSize * chunkSize]; // 0 ; Untouched, -1 ; Frontier Cells, 1 ; Spanning Tree Cells
+    short frontierCells[chunkSize * chunkSize];
+    int frontierCellsSize = 0;
+
+    memset(chunk->cells, 0, sizeof(chunk->cells));
+    memset(status, 0, sizeof(status));
+
+    int cell = nextRandom(&randomState) % (chunkSize * chunkSize);
+    while (true) {
+        status[cell] = 1;
+        int row = cell >> chunkShift;
+        int column = cell & chunkMask;
+
+        for (int direction = 0; direction < 4; direction++) { // Adjacent cells into frontier cells
+            int newRow = row + directionRowStep[direction];
+            int newColumn = column + directionColumnStep[direction];
+            if (newRow >= 0 && newRow < chunkSize && newColumn >= 0 && newColumn < chunkSize) {
+                int neighbor = (newRow << chunkShift) | newColumn;
+                if (status[neighbor] == 0) {
+                    status[neighbor] = -1;
+                    frontierCells[frontierCellsSize++] = neighbor;
+                }
+            }
+        }
+
+        if (frontierCellsSize == 0)
+            break;
+
+        // Random frontier cell, the last one takes its place
+        int randomPosition = nextRandom(&randomState) % frontierCellsSize;
+        cell = frontierCells[randomPosition];
+        frontierCells[randomPosition] = frontierCells[--frontierCellsSize];
+
+        // Random spanning tree cell next to it
+        row = cell >> chunkShift;
+        column = cell & chunkMask;
+        int treeDirections[4];
+        int treeDirectionsSize = 0;
+        for (int direction = 0; direction < 4; direction++) {
+            int newRow = row + directionRowStep[direction];
+            int newColumn = column + directionColumnStep[direction];
+            if (newRow >= 0 && newRow < chunkSize && newColumn >= 0 && newColumn < chunkSize
+                && status[(newRow << chunkShift) | newColumn] == 1) {
+                treeDirections[treeDirectionsSize++] = direction;
+            }
+        }
+        int direction = treeDirections[nextRandom(&randomState) % treeDirectionsSize];
+        int treeCell = ((row + directionRowStep[direction]) << chunkShift) | (column + directionColumnStep[direction]);
+
+        // Remove the barrier between both
+        chunk->cells[cell] |= directionOpening[direction];
+        chunk->cells[treeCell] |= directionOppositeOpening[direction];
+    }
+
+    // Doors shared with the neighbor chunks
+    int upperDoor = chunkBorderDoor(maze->seed, chunk->chunkX, chunk->chunkY, 0);
+    int lowerDoor = chunkBorderDoor(maze->seed, chunk->chunkX + 1, chunk->chunkY, 0);
+    int leftDoor = chunkBorderDoor(maze->seed, chunk->chunkX, chunk->chunkY, 1);
+    int rightDoor = chunkBorderDoor(maze->seed, chunk->chunkX, chunk->chunkY + 1, 1);
+    chunk->cells[upperDoor] |= aboveOpening;
+    chunk->cells[(chunkMask << chunkShift) | lowerDoor] |= belowOpening;
+    chunk->cells[leftDoor << chunkShift] |= leftOpening;
+    chunk->cells[(rightDoor << chunkShift) | chunkMask] |= rightOpening;
+
+    chunk->markedCells = 0;
+    maze->generatedChunks++;
+}
+
+ChunkedLaberynth *createChunkedLaberynth(unsigned long long seed, int maxLoadedChunks) {
+    /*
+    Subroutine that creates an empty chunked laberynth, no chunk is generated until a cell is requested.
+    Inputs and constraints:
+        -seed: Seed that decides every wall of the infinite laberynth.
+        -maxLoadedChunks: Number of chunks kept in memory before the least recently used one is evicted.
+    Outputs:
+        -The chunked laberynth, it must be released with freeChunkedLaberynth.
+    */
+    ChunkedLaberynth *maze = calloc(1, sizeof(ChunkedLaberynth));
+    maze->seed = seed;
+    maze->maxLoadedChunks = maxLoadedChunks > 0 ? maxLoadedChunks : 1;
+    return maze;
+}
+
+void freeChunkedLaberynth(ChunkedLaberynth *maze) {
+    /*
+    Subroutine that returns the memory of every loaded chunk and of the laberynth.
+    */
+    for (int bucket = 0; bucket < chunkBucketCount; bucket++) {
+        Chunk *chunk = maze->buckets[bucket];
+        while (chunk != NULL) {
+            Chunk *next = chunk->next;
+            free(chunk);
+            chunk = next;
+        }
+    }
+    free(maze);
+}
+
+int chunkBucket(long long chunkX, long long chunkY) {
+    return (int) (hashCoordinates(0, chunkX, chunkY, 3) & (chunkBucketCount - 1));
+}
+
+void unlinkEvictableChunk(ChunkedLaberynth *maze, Chunk *chunk) {
+    /*
+    Subroutine that takes a chunk out of the list of evictable chunks.
+    */
+    if (chunk->newer != NULL)
+        chunk->newer->older = chunk->older;
+    else
+        maze->newestChunk = chunk->older;
+    if (chunk->older != NULL)
+        chunk->older->newer = chunk->newer;
+    else
+        maze->oldestChunk = chunk->newer;
+    chunk->newer = chunk->older = NULL;
+}
+
+void pushEvictableChunk(ChunkedLaberynth *maze, Chunk *chunk) {
+    /*
+    Subroutine that puts a chunk without marks at the most recently used end of the list of evictable chunks.
+    */
+    chunk->newer = NULL;
+    chunk->older = maze->newestChunk;
+    if (maze->newestChunk != NULL)
+        maze->newestChunk->newer = chunk;
+    else
+        maze->oldestChunk = chunk;
+    maze->newestChunk = chunk;
+}
+
+Chunk *evictChunk(ChunkedLaberynth *maze) {
+    /*
+    Subroutine that removes the least recently used chunk without solver marks from the cache. The chunks without
+    marks are kept in use order, so only the bucket of the evicted chunk is walked.
+    Outputs:
+        -The evicted chunk, ready to be reused, or NULL if every loaded chunk has marks.
+    */
+    Chunk *chunk = maze->oldestChunk;
+    if (chunk == NULL)
+        return NULL;
+    unlinkEvictableChunk(maze, chunk);
+
+    Chunk **link = &maze->buckets[chunkBucket(chunk->chunkX, chunk->chunkY)];
+    while (*link != chunk)
+        link = &(*link)->next;
+    *link = chunk->next;
+    if (maze->lastChunk == chunk)
+        maze->lastChunk = NULL;
+    maze->loadedChunks--;
+    return chunk;
+}
+
+Chunk *fetchChunk(ChunkedLaberynth *maze, long long chunkX, long long chunkY) {
+    /*
+    Subroutine that returns a chunk from the cache, generating it (and evicting another one) if it is not loaded.
+    Inputs and constraints:
+        -maze: The chunked laberynth.
+        -chunkX, chunkY: Coordinates of the chunk, the cell (x, y) lives in chunk (x >> chunkShift, y >> chunkShift).
+    Outputs:
+        -The loaded chunk, or NULL if there was no memory for it. Chunks with marks stay loaded, so memory grows with
+        the explored area only.
+    */
+    Chunk *chunk = maze->lastChunk;
+    if (chunk != NULL && chunk->chunkX == chunkX && chunk->chunkY == chunkY) {
+        chunk->lastUse = ++maze->useClock;
+        if (chunk->markedCells == 0 && chunk != maze->newestChunk) { // Moved back by clearChunkedMarks
+            unlinkEvictableChunk(maze, chunk);
+            pushEvictableChunk(maze, chunk);
+        }
+        return chunk;
+    }
+
+    int bucket = chunkBucket(chunkX, chunkY);
+    for (chunk = maze->buckets[bucket]; chunk != NULL; chunk = chunk->next) {
+        if (chunk->chunkX == chunkX && chunk->chunkY == chunkY)
+            break;
+    }
+
+    if (chunk == NULL) {
+        if (maze->loadedChunks >= maze->maxLoadedChunks)
+            chunk = evictChunk(maze);
+        if (chunk == NULL)
+            chunk = malloc(sizeof(Chunk));
+        if (chunk == NULL)
+            return NULL;
+        chunk->chunkX = chunkX;
+        chunk->chunkY = chunkY;
+        generateChunk(maze, chunk);
+        chunk->next = maze->buckets[bucket];
+        maze->buckets[bucket] = chunk;
+        maze->loadedChunks++;
+        pushEvictableChunk(maze, chunk);
+    } else if (chunk->markedCells == 0) {
+        unlinkEvictableChunk(maze, chunk);
+        pushEvictableChunk(maze, chunk);
+    }
+
+    chunk->lastUse = ++maze->useClock;
+    maze->lastChunk = chunk;
+    return chunk;
+}
+
+unsigned char *chunkedCell(ChunkedLaberynth *maze, long long x, long long y) {
+    /*
+    Subroutine that gives access to a cell of the infinite laberynth through the chunk cache.
+    The pointer is valid until another cell of an unmarked chunk is requested, it is NULL without memory for the chunk.
+    */
+    Chunk *chunk = fetchChunk(maze, x >> chunkShift, y >> chunkShift);
+    if (chunk == NULL)
+        return NULL;
+    return &chunk->cells[((x & chunkMask) << chunkShift) | (y & chunkMask)];
+}
+
+int chunkedCellValue(ChunkedLaberynth *maze, long long x, long long y) {
+    unsigned char *cell = chunkedCell(maze, x, y);
+    return cell != NULL ? *cell % 16 : -1;
+}
+
+bool markChunkedCell(ChunkedLaberynth *maze, long long x, long long y, unsigned char marks) {
+    /*
+    Subroutine that stores solver marks (bits 4-7) in a cell, pinning its chunk in memory.
+    Outputs:
+        -False if there was no memory for the chunk of the cell.
+    */
+    Chunk *chunk = fetchChunk(maze, x >> chunkShift, y >> chunkShift);
+    if (chunk == NULL)
+        return false;
+    unsigned char *cell = &chunk->cells[((x & chunkMask) << chunkShift) | (y & chunkMask)];
+    if (*cell < 16 && marks != 0) {
+        if (chunk->markedCells++ == 0)
+            unlinkEvictableChunk(maze, chunk);
+    } else if (*cell >= 16 && marks == 0) {
+        if (--chunk->markedCells == 0)
+            pushEvictableChunk(maze, chunk);
+    }
+    *cell = (*cell % 16) | marks;
+    return true;
+}
+
+int compareChunkUses(const void *first, const void *second) {
+    unsigned long long a = (*(Chunk *const *) first)->lastUse;
+    unsigned long long b = (*(Chunk *const *) second)->lastUse;
+    return (a > b) - (a < b);
+}
+
+void clearChunkedMarks(ChunkedLaberynth *maze) {
+    /*
+    Subroutine that removes the marks left by a solver so every chunk can be evicted again. The chunks that had
+    marks go back into the list of evictable chunks in the order of their last use, so the list stays in use order.
+    */
+    Chunk **cleared = malloc(sizeof(Chunk *) * (maze->loadedChunks + 1));
+    int clearedCount = 0;
+    for (int bucket = 0; bucket < chunkBucketCount; bucket++) {
+        for (Chunk *chunk = maze->buckets[bucket]; chunk != NULL; chunk = chunk->next) {
+            if (chunk->markedCells > 0) {
+                for (int cell = 0; cell < chunkSize * chunkSize; cell++)
+                    chunk->cells[cell] %= 16;
+                chunk->markedCells = 0;
+                if (cleared != NULL)
+                    cleared[clearedCount++] = chunk;
+                else
+                    pushEvictableChunk(maze, chunk); // Without memory the order is only approximate
+            }
+        }
+    }
+    if (cleared == NULL)
+        return;
+
+    // Merge with the list, both are sorted by last use
+    qsort(cleared, clearedCount, sizeof(Chunk *), compareChunkUses);
+    Chunk *newer = maze->oldestChunk;
+    for (int index = 0; index < clearedCount; index++) {
+        Chunk *chunk = cleared[index];
+        while (newer != NULL && newer->lastUse < chunk->lastUse)
+            newer = newer->newer;
+        if (newer == NULL) {
+            pushEvictableChunk(maze, chunk);
+            continue;
+        }
+        chunk->newer = newer; // Goes just before newer
+        chunk->older = newer->older;
+        if (newer->older != NULL)
+            newer->older->newer = chunk;
+        else
+            maze->oldestChunk = chunk;
+        newer->older = chunk;
+    }
+    free(cleared);
+}
+
+long long randomMouseChunked(ChunkedLaberynth *maze, long long entranceX, long long entranceY, long long exitX, long long exitY, long long maxCycles, unsigned long long seed) {
+    /*
+    Subroutine that runs the random mouse on the infinite laberynth. As in newRandomPosition every open direction
+    has the same probability. The mouse leaves no marks, so the chunks it walks through can be evicted.
+    Inputs and constraints:
+        -maze: The chunked laberynth.
+        -entranceX, entranceY: Cell where the mouse starts.
+        -exitX, exitY: Cell the mouse is looking for.
+        -maxCycles: Maximum number of moves before giving up.
+        -seed: Seed of the moves of the mouse.
+    Outputs:
+        -The number of cycles needed to reach the exit, or -1 if maxCycles was not enough or a chunk could not be loaded.
+    */
+    unsigned long long randomState = seedRandom(seed);
+    long long currentPositionX = entranceX;
+    long long currentPositionY = entranceY;
+    long long totalCycles = 0;
+
+    while (currentPositionX != exitX || currentPositionY != exitY) {
+        if (totalCycles == maxCycles)
+            return -1;
+
+        int value = chunkedCellValue(maze, currentPositionX, currentPositionY);
+        if (value < 0)
+            return -1;
+        int openDirections[4];
+        int openDirectionsSize = 0;
+        if (canGoUp(value)) openDirections[openDirectionsSize++] = 0;
+        if (canGoDown(value)) openDirections[openDirectionsSize++] = 1;
+        if (canGoLeft(value)) openDirections[openDirectionsSize++] = 2;
+        if (canGoRight(value)) openDirections[openDirectionsSize++] = 3;
+
+        int direction = openDirections[nextRandom(&randomState) % openDirectionsSize];
+        currentPositionX += directionRowStep[direction];
+        currentPositionY += directionColumnStep[direction];
+        totalCycles++;
+    }
+    return totalCycles;
+}
+
+long long tremauxChunked(ChunkedLaberynth *maze, long long entranceX, long long entranceY, long long exitX, long long exitY, long long maxCycles, long long *pathLength) {
+    /*
+    Subroutine that runs Tremaux's algorithm on the infinite laberynth. Every visited cell is marked, and the
+    direction it was entered from is kept in the cell, so a dead end is left by walking the marks back.
+    Among the unmarked passages the one closest to the exit is taken first, otherwise the search can walk away forever.
+    Marked chunks stay loaded until clearChunkedMarks is called.
+    Inputs and constraints:
+        -maze: The chunked laberynth.
+        -entranceX, entranceY: Cell where the search starts.
+        -exitX, exitY: Cell the search is looking for.
+        -maxCycles: Maximum number of moves before giving up.
+        -pathLength: Pointer where the number of moves of the path found is stored, it can be NULL.
+    Outputs:
+        -The number of cycles needed to reach the exit, or -1 if maxCycles was not enough or a chunk could not be loaded.
+    */
+    long long currentPositionX = entranceX;
+    long long currentPositionY = entranceY;
+    long long totalCycles = 0;
+    long long depth = 0;
+
+    if (!markChunkedCell(maze, currentPositionX, currentPositionY, 16))
+        return -1;
+
+    while (currentPositionX != exitX || currentPositionY != exitY) {
+        if (totalCycles == maxCycles)
+            return -1;
+
+        unsigned char *currentCell = chunkedCell(maze, currentPositionX, currentPositionY);
+        if (currentCell == NULL)
+            return -1;
+        unsigned char cell = *currentCell;
+        int value = cell % 16;
+        bool moved = false;
+
+        // On an unbounded laberynth the unmarked passages are tried closest to the exit first
+        int order[4] = {0, 1, 2, 3};
+        long long distance[4];
+        for (int direction = 0; direction < 4; direction++) {
+            distance[direction] = llabs(currentPositionX + directionRowStep[direction] - exitX) + llabs(currentPositionY + directionColumnStep[direction] - exitY);
+        }
+        for (int i = 1; i < 4; i++) {
+            for (int j = i; j > 0 && distance[order[j]] < distance[order[j - 1]]; j--) {
+                int swap = order[j];
+                order[j] = order[j - 1];
+                order[j - 1] = swap;
+            }
+        }
+
+        for (int i = 0; i < 4 && !moved; i++) {
+            int direction = order[i];
+            if (!(value & directionOpening[direction]))
+                continue;
+            long long newPositionX = currentPositionX + directionRowStep[direction];
+            long long newPositionY = currentPositionY + directionColumnStep[direction];
+            unsigned char *newCell = chunkedCell(maze, newPositionX, newPositionY);
+            if (newCell == NULL)
+                return -1;
+            if (*newCell < 16) {
+                if (!markChunkedCell(maze, newPositionX, newPositionY, 16 | ((directionOpposite[direction] + 1) << 5)))
+                    return -1;
+                currentPositionX = newPositionX;
+                currentPositionY = newPositionY;
+                depth++;
+                moved = true;
+            }
+        }
+
+        if (!moved) { // Dead end, go back through the entering direction
+            int back = cell >> 5;
+            if (back == 0)
+                return -1;
+            currentPositionX += directionRowStep[back - 1];
+            currentPositionY += directionColumnStep[back - 1];
+            depth--;
+        }
+        totalCycles++;
+    }
+
+    if (pathLength != NULL)
+        *pathLength = depth;
+    return totalCycles;
+}
+
+/*******************************Cell Layouts*******************************/
+/*
+createMatrix stores the laberynth row by row, so every vertical move jumps a whole row and misses the cache
+on wide laberynths. A CellLayout hides where the cell (x, y) lives inside a flat array of cells:
+// rowMajorLayout ; Same order as createMatrix, matrix[0] can be used as the array
+// zOrderLayout ; Morton order, the bits of x and y are interleaved
+// tiledLayout ; Square tiles of tileSize x tileSize cells, row major inside the tile and between tiles
+The generator and the solvers of this section only use cellIndex, so any layout can be plugged in.
+*/
+
+#define rowMajorLayout 0
+#define zOrderLayout   1
+#define tiledLayout    2
+
+#define tileShift 3
+#define tileSize (1 << tileShift)
+#define tileMask (tileSize - 1)
+
+const char *cellLayoutNames[] = {"row-major", "z-order", "tiled"};
+
+typedef struct {
+    int kind;
+    int rows;
+    int columns;
+    int mortonShift;  // Bits of x and y interleaved, the rest of the longest side goes above them
+    bool mortonRowsLonger;
+    int tilesPerRow;
+    size_t size;      // Cells needed by the array, padding included
+} CellLayout;
+
+int ceilLog2(int value) {
+    int shift = 0;
+    while ((1 << shift) < value)
+        shift++;
+    return shift;
+}
+
+unsigned long long spreadBits(unsigned int value) {
+    /*
+    Subroutine that moves bit i of value to bit 2i of the result, so two spread coordinates can be interleaved.
+    References:
+        -Anderson, S. E. (n.d.). Bit Twiddling Hacks, Interleave bits by Binary Magic Numbers. https://graphics.stanford.edu/~seander/bithacks.html
+    */
+    unsigned long long bits = value;
+    bits = (bits | (bits << 16)) & 0x0000FFFF0000FFFFULL;
+    bits = (bits | (bits << 8)) & 0x00FF00FF00FF00FFULL;
+    bits = (bits | (bits << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    bits = (bits | (bits << 2)) & 0x3333333333333333ULL;
+    bits = (bits | (bits << 1)) & 0x5555555555555555ULL;
+    return bits;
+}
+
+static inline size_t cellIndex(const CellLayout *layout, int x, int y) {
+    /*
+    Subroutine that gives the position of the cell (x, y) in the flat array of a layout.
+    Inputs and constraints:
+        -layout: Layout created with createCellLayout.
+        -x: Row of the cell, 0 <= x < rows.
+        -y: Column of the cell, 0 <= y < columns.
+    Outputs:
+        -Index of the cell in the array.
+    */
+    switch (layout->kind) {
+    case zOrderLayout: {
+        unsigned int mask = (1u << layout->mortonShift) - 1;
+        size_t morton = (spreadBits(x & mask) << 1) | spreadBits(y & mask);
+        size_t high = layout->mortonRowsLonger ? (size_t) (x >> layout->mortonShift) : (size_t) (y >> layout->mortonShift);
+        return (high << (2 * layout->mortonShift)) | morton;
+    }
+    case tiledLayout: {
+        size_t tile = (size_t) (x >> tileShift) * layout->tilesPerRow + (y >> tileShift);
+        return (tile << (2 * tileShift)) | ((x & tileMask) << tileShift) | (y & tileMask);
+    }
+    default:
+        return (size_t) x * layout->columns + y;
+    }
+}
+
+CellLayout createCellLayout(int kind, int rows, int columns) {
+    /*
+    Subroutine that prepares a layout for a laberynth of rows x columns cells.
+    Inputs and constraints:
+        -kind: rowMajorLayout, zOrderLayout or tiledLayout.
+        -rows: Positive number of rows.
+        -columns: Positive number of columns.
+    Outputs:
+        -The layout, its size field tells how many cells the array needs.
+    */
+    CellLayout layout;
+    layout.kind = kind;
+    layout.rows = rows;
+    layout.columns = columns;
+    layout.tilesPerRow = (columns + tileMask) >> tileShift;
+
+    int rowsShift = ceilLog2(rows);
+    int columnsShift = ceilLog2(columns);
+    layout.mortonRowsLonger = rowsShift > columnsShift;
+    layout.mortonShift = layout.mortonRowsLonger ? columnsShift : rowsShift;
+
+    if (kind == zOrderLayout) {
+        layout.size = (size_t) 1 << (rowsShift + columnsShift);
+    } else if (kind == tiledLayout) {
+        layout.size = (size_t) ((rows + tileMask) >> tileShift) * layout.tilesPerRow * tileSize * tileSize;
+    } else {
+        layout.size = (size_t) rows * columns;
+    }
+    return layout;
+}
+
+/*
+The generator of generateLaberynthCells keeps its whole state in a LaberynthGenerator, so it can be advanced a
+number of cells at a time and its state can be saved and restored (Generation Checkpoints). Every write to the
+cells or to the frontier marks its block of generatorBlockSize values as dirty, so a checkpoint only saves the
+blocks that changed since the previous one. Both frontier arrays share one dirty map.
+*/
+
+#define generatorBlockShift 14
+#define generatorBlockSize (1 << generatorBlockShift)
+#define generatorRegions 3 // Cells, frontier X positions, frontier Y positions
+
+typedef struct {
+    unsigned long long randomState;
+    int positionX;                 // Cell added last, its neighbors are not frontier cells yet
+    int positionY;
+    int initialCellXPosition;
+    int initialCellYPosition;
+    unsigned long long frontierCellsArraySize;
+    unsigned long long addedCells;
+    unsigned long long finished;
+} GeneratorState;
+
+typedef struct {
+    int *cells;
+    CellLayout layout;
+    unsigned long long seed;
+    int *frontierCellsXPosition;
+    int *frontierCellsYPosition;
+    bool ownsMemory;               // The generator allocated its own buffer
+    GeneratorState state;
+    int *region[generatorRegions];
+    size_t regionSize[generatorRegions];
+    unsigned char *dirty[2];       // One byte per block of the cells and of the frontier
+} LaberynthGenerator;
+
+static inline void markGeneratorDirty(LaberynthGenerator *generator, int region, size_t index) {
+    generator->dirty[region][index >> generatorBlockShift] = 1;
+}
+
+static inline size_t alignedBytes(size_t bytes) {
+    return (bytes + 15) & ~(size_t) 15;
+}
+
+size_t laberynthGeneratorBytes(const CellLayout *layout) {
+    /*
+    Subroutine that gives the size of the buffer of a generator: the generator, its two frontier arrays and its
+    two dirty maps.
+    */
+    size_t totalCells = (size_t) layout->rows * layout->columns;
+    return alignedBytes(sizeof(LaberynthGenerator)) + 2 * alignedBytes(sizeof(int) * totalCells)
+        + alignedBytes((layout->size >> generatorBlockShift) + 1) + alignedBytes((totalCells >> generatorBlockShift) + 1);
+}
+
+LaberynthGenerator *createLaberynthGeneratorWithBuffer(int *cells, const CellLayout *layout, unsigned long long seed, void *buffer) {
+    /*
+    Subroutine that prepares the generation of a laberynth and does step one (the initial cell).
+    Inputs and constraints:
+        -cells: Array of at least layout->size integers.
+        -layout: Layout of the array.
+        -seed: Seed of the laberynth.
+        -buffer: laberynthGeneratorBytes bytes owned by the caller (an arena) that hold the whole generator, or NULL
+        to allocate them here.
+    Outputs:
+        -The generator, released with freeLaberynthGenerator, or NULL if there is no memory.
+    */
+    bool ownsMemory = buffer == NULL;
+    if (ownsMemory && (buffer = malloc(laberynthGeneratorBytes(layout))) == NULL)
+        return NULL;
+    size_t totalCells = (size_t) layout->rows * layout->columns;
+    unsigned char *next = buffer;
+    LaberynthGenerator *generator = (LaberynthGenerator *) next;
+    memset(generator, 0, sizeof(LaberynthGenerator));
+    next += alignedBytes(sizeof(LaberynthGenerator));
+    generator->cells = cells;
+    generator->layout = *layout;
+    generator->seed = seed;
+    generator->ownsMemory = ownsMemory;
+    generator->frontierCellsXPosition = (int *) next;
+    next += alignedBytes(sizeof(int) * totalCells);
+    generator->frontierCellsYPosition = (int *) next;
+    next += alignedBytes(sizeof(int) * totalCells);
+    generator->region[0] = cells;
+    generator->region[1] = generator->frontierCellsXPosition;
+    generator->region[2] = generator->frontierCellsYPosition;
+    generator->regionSize[0] = layout->size;
+    generator->regionSize[1] = totalCells;
+    generator->regionSize[2] = totalCells;
+    for (int region = 0; region < 2; region++) {
+        size_t blocks = (generator->regionSize[region] >> generatorBlockShift) + 1;
+        generator->dirty[region] = memset(next, 0, blocks);
+        next += alignedBytes(blocks);
+    }
+
+    memset(cells, 0, sizeof(int) * layout->size);
+
+    // Step one
+    GeneratorState *state = &generator->state;
+    state->randomState = seedRandom(seed);
+    state->positionX = nextRandom(&state->randomState) % layout->rows;
+    state->positionY = nextRandom(&state->randomState) % layout->columns;
+    state->initialCellXPosition = state->positionX;
+    state->initialCellYPosition = state->positionY;
+    size_t initial = cellIndex(layout, state->positionX, state->positionY);
+    cells[initial] = initialCellStarterValue;
+    markGeneratorDirty(generator, 0, initial);
+    state->addedCells = 1;
+    return generator;
+}
+
+LaberynthGenerator *createLaberynthGenerator(int *cells, const CellLayout *layout, unsigned long long seed) {
+    return createLaberynthGeneratorWithBuffer(cells, layout, seed, NULL);
+}
+
+void freeLaberynthGenerator(LaberynthGenerator *generator) {
+    if (generator->ownsMemory)
+        free(generator); // The start of the buffer
+}
+
+bool stepLaberynthGenerator(LaberynthGenerator *generator, long long steps) {
+    /*
+    Subroutine that adds up to steps cells to the laberynth, and does step five when the frontier is empty.
+    Inputs and constraints:
+        -generator: The generator.
+        -steps: Maximum number of cells to add.
+    Outputs:
+        -true once the laberynth is finished.
+    */
+    const CellLayout *layout = &generator->layout;
+    int rows = layout->rows;
+    int columns = layout->columns;
+    int *cells = generator->cells;
+    int *frontierCellsXPosition = generator->frontierCellsXPosition;
+    int *frontierCellsYPosition = generator->frontierCellsYPosition;
+    GeneratorState state = generator->state;
+    if (state.finished)
+        return true;
+
+    for (long long step = 0; step < steps; step++) {
+        // Adjacent cells into frontier cells
+        for (int direction = 0; direction < 4; direction++) {
+            int newPositionX = state.positionX + directionRowStep[direction];
+            int newPositionY = state.positionY + directionColumnStep[direction];
+            if (newPositionX >= 0 && newPositionX < rows && newPositionY >= 0 && newPositionY < columns) {
+                size_t neighbor = cellIndex(layout, newPositionX, newPositionY);
+                if (cells[neighbor] == 0) {
+                    cells[neighbor] = -1;
+                    markGeneratorDirty(generator, 0, neighbor);
+                    frontierCellsXPosition[state.frontierCellsArraySize] = newPositionX;
+                    frontierCellsYPosition[state.frontierCellsArraySize] = newPositionY;
+                    markGeneratorDirty(generator, 1, state.frontierCellsArraySize);
+                    state.frontierCellsArraySize++;
+                }
+            }
+        }
+
+        // Step four
+        if (state.frontierCellsArraySize == 0) {
+            // Step five
+            size_t entrance = cellIndex(layout, 0, 0);
+            size_t exit = cellIndex(layout, rows - 1, columns - 1);
+            size_t initial = cellIndex(layout, state.initialCellXPosition, state.initialCellYPosition);
+            cells[entrance] += aboveOpening;
+            cells[exit] += belowOpening;
+            cells[initial] -= initialCellStarterValue;
+            markGeneratorDirty(generator, 0, entrance);
+            markGeneratorDirty(generator, 0, exit);
+            markGeneratorDirty(generator, 0, initial);
+            state.finished = 1;
+            break;
+        }
+
+        // Steps two and three, the last frontier cell takes the place of the selected one
+        size_t randomPosition = nextRandom(&state.randomState) % state.frontierCellsArraySize;
+        state.positionX = frontierCellsXPosition[randomPosition];
+        state.positionY = frontierCellsYPosition[randomPosition];
+        state.frontierCellsArraySize--;
+        frontierCellsXPosition[randomPosition] = frontierCellsXPosition[state.frontierCellsArraySize];
+        frontierCellsYPosition[randomPosition] = frontierCellsYPosition[state.frontierCellsArraySize];
+        markGeneratorDirty(generator, 1, randomPosition);
+
+        int treeDirections[4];
+        int treeDirectionsSize = 0;
+        for (int direction = 0; direction < 4; direction++) {
+            int newPositionX = state.positionX + directionRowStep[direction];
+            int newPositionY = state.positionY + directionColumnStep[direction];
+            if (newPositionX >= 0 && newPositionX < rows && newPositionY >= 0 && newPositionY < columns
+                && cells[cellIndex(layout, newPositionX, newPositionY)] > 0) {
+                treeDirections[treeDirectionsSize++] = direction;
+            }
+        }
+        int direction = treeDirections[nextRandom(&state.randomState) % treeDirectionsSize];
+        size_t added = cellIndex(layout, state.positionX, state.positionY);
+        size_t tree = cellIndex(layout, state.positionX + directionRowStep[direction], state.positionY + directionColumnStep[direction]);
+        cells[added] = directionOpening[direction];
+        cells[tree] += directionOppositeOpening[direction];
+        markGeneratorDirty(generator, 0, added);
+        markGeneratorDirty(generator, 0, tree);
+        state.addedCells++;
+    }
+    generator->state = state;
+    return state.finished != 0;
+}
+
+void generateLaberynthCells(int *cells, const CellLayout *layout, unsigned long long seed) {
+    /*
+    Subroutine that builds a laberynth with the same algorithm and the same values as createLaberynth, but on a
+    flat array in any layout and with a seeded generator, so big laberynths do not depend on rand() or on the stack.
+    Inputs and constraints:
+        -cells: Array of at least layout->size integers.
+        -layout: Layout of the array.
+        -seed: Seed of the laberynth, the same seed and size always give the same laberynth.
+    Outputs:
+        -The array with the values of the laberynth, entrance above (0, 0) and exit below (rows - 1, columns - 1).
+    References:
+        -Matuszek, D. (n.d.). How to build a maze. Retrieved from https://www-fourier.ujf-grenoble.fr/~faure/enseignement/projets_simulation/labyrinthe/construct_a_maze.pdf
+    */
+    LaberynthGenerator *generator = createLaberynthGenerator(cells, layout, seed);
+    stepLaberynthGenerator(generator, LLONG_MAX);
+    freeLaberynthGenerator(generator);
+}
+
+void generateLaberynthCellsWithBuffer(int *cells, const CellLayout *layout, unsigned long long seed, void *buffer) {
+    /*
+    Subroutine that is generateLaberynthCells with the generator in a buffer of laberynthGeneratorBytes bytes given
+    by the caller, so repeated generations do not allocate anything.
+    */
+    LaberynthGenerator *generator = createLaberynthGeneratorWithBuffer(cells, layout, seed, buffer);
+    stepLaberynthGenerator(generator, LLONG_MAX);
+    freeLaberynthGenerator(generator);
+}
+
+long long randomMouseCells(int *cells, const CellLayout *layout, long long maxCycles, unsigned long long seed) {
+    /*
+    Subroutine that runs the random mouse of randomMouse on a laberynth stored in any layout, marking the
+    cells of its path with + 16 in the same way.
+    Inputs and constraints:
+        -cells: Array with the laberynth.
+        -layout: Layout of the array.
+        -maxCycles: Maximum number of moves.
+        -seed: Seed of the moves of the mouse.
+    Outputs:
+        -The number of cycles needed to reach the exit, or maxCycles if it was not reached.
+    */
+    int rows = layout->rows;
+    int columns = layout->columns;
+    unsigned long long randomState = seedRandom(seed);
+    int currentPositionX = 0;
+    int currentPositionY = 0;
+    size_t current = cellIndex(layout, 0, 0);
+    long long totalCycles = 0;
+
+    cells[current] += 16;
+    while ((currentPositionX != rows - 1 || currentPositionY != columns - 1) && totalCycles < maxCycles) {
+        int value = cells[current] % 16;
+        int direction;
+        do { // Same rejection loop as newRandomPosition
+            direction = nextRandom(&randomState) % 4;
+        } while (!(value & directionOpening[direction])
+                 || currentPositionX + directionRowStep[direction] < 0 || currentPositionX + directionRowStep[direction] >= rows);
+
+        currentPositionX += directionRowStep[direction];
+        currentPositionY += directionColumnStep[direction];
+        size_t next = cellIndex(layout, currentPositionX, currentPositionY);
+
+        if (cells[next] > 15) {
+            cells[current] -= 16;
+        } else {
+            cells[next] += 16;
+        }
+        current = next;
+        totalCycles++;
+    }
+    return totalCycles;
+}
+
+long long tremauxCells(int *cells, const CellLayout *layout, long long maxCycles) {
+    /*
+    Subroutine that runs Tremaux's algorithm from the entrance to the exit on a laberynth stored in any layout.
+    Visited cells get + 16 and the direction back to the cell they were entered from is kept in bits 5 and 6
+    (+ 32 * direction), so dead ends are left by following the marks back.
+    Inputs and constraints:
+        -cells: Array with the laberynth, without marks.
+        -layout: Layout of the array.
+        -maxCycles: Maximum number of moves.
+    Outputs:
+        -The number of cycles needed to reach the exit, or maxCycles if it was not reached.
+    */
+    int rows = layout->rows;
+    int columns = layout->columns;
+    int currentPositionX = 0;
+    int currentPositionY = 0;
+    long long totalCycles = 0;
+
+    cells[cellIndex(layout, 0, 0)] += 16;
+    while ((currentPositionX != rows - 1 || currentPositionY != columns - 1) && totalCycles < maxCycles) {
+        int value = cells[cellIndex(layout, currentPositionX, currentPositionY)];
+        bool moved = false;
+
+        for (int direction = 0; direction < 4 && !moved; direction++) {
+            int newPositionX = currentPositionX + directionRowStep[direction];
+            int newPositionY = currentPositionY + directionColumnStep[direction];
+            if ((value & directionOpening[direction]) && newPositionX >= 0 && newPositionX < rows) {
+                int *neighbor = &cells[cellIndex(layout, newPositionX, newPositionY)];
+                if (*neighbor < 16) {
+                    *neighbor += 16 + 32 * directionOpposite[direction];
+                    currentPositionX = newPositionX;
+                    currentPositionY = newPositionY;
+                    moved = true;
+                }
+            }
+        }
+
+        if (!moved) { // Dead end, go back
+            int back = (value >> 5) & 3;
+            currentPositionX += directionRowStep[back];
+            currentPositionY += directionColumnStep[back];
+        }
+        totalCycles++;
+    }
+    return totalCycles;
+}
+
+/*******************************Packed Laberynths*******************************/
+/*
+An int per cell is 8 times more than the 4 opening bits need. A packed laberynth keeps the cells row by row in:
+// nibblePacking ; The 4 opening bits of every cell, 2 cells per byte
+// halfWallPacking ; Only the right (1) and below (2) opening bits, 4 cells per byte. The above opening of a cell
+//                   is the below opening of the cell above it and the left opening is the right opening of the
+//                   cell on its left, so removing a barrier writes one cell instead of two.
+The entrance above (0, 0) has no cell above it to hold it, so it is kept apart in entranceOpen.
+Solver marks (+ 16) are not stored.
+*/
+
+#define nibblePacking   0
+#define halfWallPacking 1
+
+typedef struct {
+    int mode;
+    int rows;
+    int columns;
+    bool entranceOpen;
+    size_t bytes;
+    unsigned char *data;
+    void *mapping;       // File mapped by mapLaberynthBinary, NULL if data was allocated
+    size_t mappingBytes;
+} PackedLaberynth;
+
+PackedLaberynth *createPackedLaberynth(int rows, int columns, int mode) {
+    /*
+    Subroutine that creates a packed laberynth with every barrier in place.
+    Inputs and constraints:
+        -rows, columns: Size of the laberynth.
+        -mode: nibblePacking or halfWallPacking.
+    Outputs:
+        -The packed laberynth, it must be released with freePackedLaberynth.
+    */
+    PackedLaberynth *packed = malloc(sizeof(PackedLaberynth));
+    size_t totalCells = (size_t) rows * columns;
+    packed->mode = mode;
+    packed->rows = rows;
+    packed->columns = columns;
+    packed->entranceOpen = false;
+    packed->bytes = mode == halfWallPacking ? (totalCells + 3) / 4 : (totalCells + 1) / 2;
+    packed->data = calloc(packed->bytes, 1);
+    packed->mapping = NULL;
+    packed->mappingBytes = 0;
+    return packed;
+}
+
+void freePackedLaberynth(PackedLaberynth *packed) {
+    if (packed->mapping != NULL)
+        munmap(packed->mapping, packed->mappingBytes);
+    else
+        free(packed->data);
+    free(packed);
+}
+
+static inline int packedBits(const PackedLaberynth *packed, size_t index) {
+    /*
+    Subroutine that reads the stored bits of a cell: the 4 openings, or only right and below in half wall mode.
+    */
+    if (packed->mode == halfWallPacking)
+        return (packed->data[index >> 2] >> ((index & 3) * 2)) & 3;
+    return (packed->data[index >> 1] >> ((index & 1) * 4)) & 15;
+}
+
+static inline void setPackedBits(PackedLaberynth *packed, size_t index, int bits) {
+    if (packed->mode == halfWallPacking) {
+        int shift = (index & 3) * 2;
+        packed->data[index >> 2] = (packed->data[index >> 2] & ~(3 << shift)) | ((bits & 3) << shift);
+    } else {
+        int shift = (index & 1) * 4;
+        packed->data[index >> 1] = (packed->data[index >> 1] & ~(15 << shift)) | ((bits & 15) << shift);
+    }
+}
+
+bool packedCanGoRight(const PackedLaberynth *packed, int x, int y) {
+    return packedBits(packed, (size_t) x * packed->columns + y) & rightOpening;
+}
+
+bool packedCanGoDown(const PackedLaberynth *packed, int x, int y) {
+    return packedBits(packed, (size_t) x * packed->columns + y) & belowOpening;
+}
+
+bool packedCanGoLeft(const PackedLaberynth *packed, int x, int y) {
+    if (packed->mode == nibblePacking)
+        return packedBits(packed, (size_t) x * packed->columns + y) & leftOpening;
+    return y > 0 && (packedBits(packed, (size_t) x * packed->columns + y - 1) & rightOpening);
+}
+
+bool packedCanGoUp(const PackedLaberynth *packed, int x, int y) {
+    if (packed->mode == nibblePacking)
+        return packedBits(packed, (size_t) x * packed->columns + y) & aboveOpening;
+    if (x == 0)
+        return y == 0 && packed->entranceOpen;
+    return packedBits(packed, (size_t) (x - 1) * packed->columns + y) & belowOpening;
+}
+
+int packedCellValue(const PackedLaberynth *packed, int x, int y) {
+    /*
+    Subroutine that rebuilds the value of a cell with the rules of the matrix (1 Right, 2 Below, 4 Left, 8 Above),
+    so canGoUp and the rest of the border table keep working on packed laberynths.
+    Inputs and constraints:
+        -packed: The packed laberynth.
+        -x, y: Row and column of the cell.
+    Outputs:
+        -Value between 0 and 15 of the cell.
+    */
+    if (packed->mode == nibblePacking)
+        return packedBits(packed, (size_t) x * packed->columns + y);
+    return packedBits(packed, (size_t) x * packed->columns + y)
+        | (packedCanGoLeft(packed, x, y) ? leftOpening : 0)
+        | (packedCanGoUp(packed, x, y) ? aboveOpening : 0);
+}
+
+void packedSetBarrierCell(PackedLaberynth *packed, int firstX, int firstY, int secondX, int secondY, bool open) {
+    /*
+    Subroutine that removes (open = true) or restores the barrier between two adjacent cells. In half wall mode
+    only the upper or left cell of the pair is written.
+    Inputs and constraints:
+        -packed: The packed laberynth.
+        -firstX, firstY, secondX, secondY: Two cells that share a border.
+        -open: true to remove the barrier, false to put it back.
+    Outputs:
+        -The packed laberynth with the barrier updated.
+    */
+    if (firstX > secondX || firstY > secondY) { // The first cell is the upper or the left one
+        int swap = firstX; firstX = secondX; secondX = swap;
+        swap = firstY; firstY = secondY; secondY = swap;
+    }
+    int opening = firstX != secondX ? belowOpening : rightOpening;
+    int oppositeOpening = firstX != secondX ? aboveOpening : leftOpening;
+
+    size_t first = (size_t) firstX * packed->columns + firstY;
+    setPackedBits(packed, first, open ? packedBits(packed, first) | opening : packedBits(packed, first) & ~opening);
+    if (packed->mode == nibblePacking) {
+        size_t second = (size_t) secondX * packed->columns + secondY;
+        setPackedBits(packed, second, open ? packedBits(packed, second) | oppositeOpening : packedBits(packed, second) & ~oppositeOpening);
+    }
+}
+
+void packedRemoveBarrierCell(PackedLaberynth *packed, int frontierX, int frontierY, int spanningTreeCellX, int spanningTreeCellY) {
+    /*
+    Subroutine with the same contract as removeBarrierCell for packed laberynths.
+    */
+    packedSetBarrierCell(packed, frontierX, frontierY, spanningTreeCellX, spanningTreeCellY, true);
+}
+
+PackedLaberynth *packLaberynth(int **matrix, int rows, int columns, int mode) {
+    /*
+    Subroutine that stores a laberynth of the matrix in a packed laberynth, the solver marks are dropped.
+    Inputs and constraints:
+        -matrix: Matrix with the laberynth.
+        -rows, columns: Size of the matrix.
+        -mode: nibblePacking or halfWallPacking.
+    Outputs:
+        -The packed laberynth.
+    */
+    PackedLaberynth *packed = createPackedLaberynth(rows, columns, mode);
+    packed->entranceOpen = canGoUp(matrix[0][0] % 16);
+    for (int x = 0; x < rows; x++) {
+        for (int y = 0; y < columns; y++) {
+            setPackedBits(packed, (size_t) x * columns + y, matrix[x][y] % 16);
+        }
+    }
+    return packed;
+}
+
+int **unpackLaberynth(const PackedLaberynth *packed) {
+    /*
+    Subroutine that creates a matrix with the values of a packed laberynth.
+    */
+    int **matrix = createMatrix(packed->rows, packed->columns);
+    for (int x = 0; x < packed->rows; x++) {
+        for (int y = 0; y < packed->columns; y++) {
+            matrix[x][y] = packedCellValue(packed, x, y);
+        }
+    }
+    return matrix;
+}
+
+void packedLaberynthDemo(int rows, int columns) {
+    /*
+    Subroutine that packs a laberynth in both modes, checks that every cell gives back the same value and prints
+    the memory of each representation.
+    */
+    int **matrix = createMatrix(rows, columns);
+    CellLayout layout = createCellLayout(rowMajorLayout, rows, columns);
+    generateLaberynthCells(matrix[0], &layout, 1);
+
+    PackedLaberynth *nibbles = packLaberynth(matrix, rows, columns, nibblePacking);
+    PackedLaberynth *halfWalls = packLaberynth(matrix, rows, columns, halfWallPacking);
+    long long differentCells = 0;
+    for (int x = 0; x < rows; x++) {
+        for (int y = 0; y < columns; y++) {
+            if (packedCellValue(nibbles, x, y) != matrix[x][y] || packedCellValue(halfWalls, x, y) != matrix[x][y])
+                differentCells++;
+        }
+    }
+
+    printf("Matrix: %zu bytes\n", sizeof(int) * (size_t) rows * columns);
+    printf("Nibble packing: %zu bytes\n", nibbles->bytes);
+    printf("Half wall packing: %zu bytes\n", halfWalls->bytes);
+    printf("Different cells: %lld\n", differentCells);
+
+    freePackedLaberynth(nibbles);
+    freePackedLaberynth(halfWalls);
+    freeMatrix(matrix, rows);
+}
+
+/*******************************Performance Counters*******************************/
+
+int openPerfCounter(unsigned int type, unsigned long long config) {
+    /*
+    Subroutine that opens a hardware counter of the current thread with perf_event_open.
+    Inputs and constraints:
+        -type: PERF_TYPE_HARDWARE or PERF_TYPE_HW_CACHE.
+        -config: Event to count, for example PERF_COUNT_HW_CACHE_MISSES.
+    Outputs:
+        -File descriptor of the counter, or -1 if the system does not allow it (containers, paranoid kernels).
+    */
+    struct perf_event_attr attributes;
+    memset(&attributes, 0, sizeof(attributes));
+    attributes.type = type;
+    attributes.size = sizeof(attributes);
+    attributes.config = config;
+    attributes.disabled = 1;
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv = 1;
+    return (int) syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0);
+}
+
+void startPerfCounter(int counter) {
+    if (counter >= 0) {
+        ioctl(counter, PERF_EVENT_IOC_RESET, 0);
+        ioctl(counter, PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+long long stopPerfCounter(int counter) {
+    /*
+    Subroutine that stops a counter and reads it.
+    Outputs:
+        -The number of events counted, or -1 if the counter is not available.
+    */
+    long long count = -1;
+    if (counter >= 0) {
+        ioctl(counter, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(counter, &count, sizeof(count)) != sizeof(count))
+            count = -1;
+    }
+    return count;
+}
+
+double elapsedSeconds(struct timespec start) {
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+void benchmarkCellLayouts(int rows, int columns, long long steps, unsigned long long seed) {
+    /*
+    Subroutine that compares the layouts on the same laberynth: generation time, Tremaux and random mouse
+    steps per second and the cache misses of each solver. The laberynth should be bigger than the last
+    level cache (4096 x 4096 cells are 64 MB).
+    Inputs and constraints:
+        -rows, columns: Size of the laberynth.
+        -steps: Maximum number of moves of each solver.
+        -seed: Seed of the laberynth and of the mouse.
+    Outputs:
+        -One line per layout printed on the standard output.
+    */
+    int cacheMisses = openPerfCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+    if (cacheMisses < 0)
+        printf("Cache miss counter not available, only times are reported\n");
+
+    printf("%-10s %12s %16s %14s %16s %14s\n", "layout", "generate s", "tremaux steps/s", "tremaux miss", "mouse steps/s", "mouse miss");
+    for (int kind = rowMajorLayout; kind <= tiledLayout; kind++) {
+        CellLayout layout = createCellLayout(kind, rows, columns);
+        int *cells = malloc(sizeof(int) * layout.size);
+        struct timespec start;
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        generateLaberynthCells(cells, &layout, seed);
+        double generateSeconds = elapsedSeconds(start);
+
+        for (size_t cell = 0; cell < layout.size; cell++)
+            cells[cell] %= 16;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        startPerfCounter(cacheMisses);
+        long long tremauxSteps = tremauxCells(cells, &layout, steps);
+        long long tremauxMisses = stopPerfCounter(cacheMisses);
+        double tremauxSeconds = elapsedSeconds(start);
+
+        for (size_t cell = 0; cell < layout.size; cell++)
+            cells[cell] %= 16;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        startPerfCounter(cacheMisses);
+        long long mouseSteps = randomMouseCells(cells, &layout, steps, seed);
+        long long mouseMisses = stopPerfCounter(cacheMisses);
+        double mouseSeconds = elapsedSeconds(start);
+
+        printf("%-10s %12.3f %16.0f %14lld %16.0f %14lld\n", cellLayoutNames[kind], generateSeconds,
+               tremauxSteps / tremauxSeconds, tremauxMisses, mouseSteps / mouseSeconds, mouseMisses);
+        free(cells);
+    }
+    if (cacheMisses >= 0)
+        close(cacheMisses);
+}
+
+/*******************************Priority Queue*******************************/
+
+typedef struct {
+    long long priority;
+    int item;
+} HeapEntry;
+
+typedef struct {
+    HeapEntry *entries;
+    int size;
+    int capacity;
+} MinHeap;
+
+void heapPush(MinHeap *heap, long long priority, int item) {
+    /*
+    Subroutine that inserts an item in a binary min heap, growing it when it is full.
+    Inputs and constraints:
+        -heap: Heap, a zeroed MinHeap is a valid empty heap.
+        -priority: Priority of the item, the smallest one leaves first.
+        -item: Value stored with the priority.
+    Outputs:
+        -The heap with the item inserted.
+    */
+    if (heap->size == heap->capacity) {
+        heap->capacity = heap->capacity > 0 ? heap->capacity * 2 : 64;
+        heap->entries = realloc(heap->entries, sizeof(HeapEntry) * heap->capacity);
+    }
+    int position = heap->size++;
+    while (position > 0 && heap->entries[(position - 1) / 2].priority > priority) {
+        heap->entries[position] = heap->entries[(position - 1) / 2];
+        position = (position - 1) / 2;
+    }
+    heap->entries[position].priority = priority;
+    heap->entries[position].item = item;
+}
+
+HeapEntry heapPop(MinHeap *heap) {
+    /*
+    Subroutine that removes the entry with the smallest priority, the heap must not be empty.
+    */
+    HeapEntry top = heap->entries[0];
+    HeapEntry last = heap->entries[--heap->size];
+    int position = 0;
+    while (true) {
+        int child = 2 * position + 1;
+        if (child >= heap->size)
+            break;
+        if (child + 1 < heap->size && heap->entries[child + 1].priority < heap->entries[child].priority)
+            child++;
+        if (heap->entries[child].priority >= last.priority)
+            break;
+        heap->entries[position] = heap->entries[child];
+        position = child;
+    }
+    if (heap->size > 0)
+        heap->entries[position] = last;
+    return top;
+}
+
+void freeHeap(MinHeap *heap) {
+    free(heap->entries);
+    heap->entries = NULL;
+    heap->size = heap->capacity = 0;
+}
+
+/*******************************Junction Graph*******************************/
+/*
+Most cells of a perfect laberynth are corridors with exactly two openings. The junction graph keeps only the
+other cells (dead ends and junctions, plus the entrance and the exit) as nodes, and every corridor between two
+of them becomes one edge weighted with the number of moves it takes. The edges are stored in compressed sparse
+row (CSR) form: the edges of node i are edgeStart[i] .. edgeStart[i + 1] - 1.
+*/
+
+typedef struct {
+    int rows;
+    int columns;
+    int nodeCount;
+    int edgeCount;
+    int *nodeCell;                // Cell (x * columns + y) of every node
+    int *cellNode;                // Node of every cell, -1 for corridor cells
+    int *edgeStart;
+    int *edgeTarget;
+    int *edgeWeight;
+    unsigned char *edgeDirection; // First move of the corridor from the node
+} JunctionGraph;
+
+int insideOpenings(int **matrix, int rows, int columns, int x, int y) {
+    /*
+    Subroutine that gives the openings of a cell that lead to another cell, the entrance and exit openings
+    leave the laberynth and are not included.
+    */
+    int openings = matrix[x][y] % 16;
+    if (x == 0) openings &= ~aboveOpening;
+    if (x == rows - 1) openings &= ~belowOpening;
+    if (y == 0) openings &= ~leftOpening;
+    if (y == columns - 1) openings &= ~rightOpening;
+    return openings;
+}
+
+int walkCorridor(int **matrix, int rows, int columns, const int *cellNode, int cell, int direction, int *length, int *pathX, int *pathY) {
+    /*
+    Subroutine that follows a corridor from a node until it reaches another node.
+    Inputs and constraints:
+        -matrix, rows, columns: The laberynth.
+        -cellNode: Node of every cell, -1 for corridor cells.
+        -cell: Cell of the node where the walk starts.
+        -direction: First move, it must be an opening of the cell.
+        -length: Pointer where the number of moves is stored.
+        -pathX, pathY: Arrays where the cells entered are written, or NULL.
+    Outputs:
+        -The cell of the node at the other end of the corridor.
+    */
+    int x = cell / columns;
+    int y = cell % columns;
+    int moves = 0;
+    while (true) {
+        x += directionRowStep[direction];
+        y += directionColumnStep[direction];
+        if (pathX != NULL) {
+            pathX[moves] = x;
+            pathY[moves] = y;
+        }
+        moves++;
+        cell = x * columns + y;
+        if (cellNode[cell] >= 0)
+            break;
+
+        // Corridor cell, leave through the opening that is not the one we came from
+        int openings = insideOpenings(matrix, rows, columns, x, y) & ~directionOpening[directionOpposite[direction]];
+        for (direction = 0; !(openings & directionOpening[direction]); direction++);
+    }
+    *length = moves;
+    return cell;
+}
+
+JunctionGraph *buildJunctionGraph(int **matrix, int rows, int columns) {
+    /*
+    Subroutine that contracts the corridors of a laberynth into the weighted edges of a junction graph.
+    Inputs and constraints:
+        -matrix: Matrix with the laberynth, solver marks are ignored.
+        -rows, columns: Size of the matrix.
+    Outputs:
+        -The junction graph, it must be released with freeJunctionGraph. Corridors that close a loop without any
+        node are not reachable from a node and are left out. NULL if the cells do not fit the int cell numbers of
+        the graph.
+    */
+    size_t totalCells = (size_t) rows * columns;
+    if (totalCells > INT_MAX)
+        return NULL;
+    JunctionGraph *graph = malloc(sizeof(JunctionGraph));
+    graph->rows = rows;
+    graph->columns = columns;
+    graph->cellNode = malloc(sizeof(int) * totalCells);
+
+    // Nodes: every cell that is not a corridor
+    int nodeCount = 0;
+    int edgeCount = 0;
+    for (int x = 0; x < rows; x++) {
+        for (int y = 0; y < columns; y++) {
+            int degree = __builtin_popcount(insideOpenings(matrix, rows, columns, x, y));
+            bool isNode = degree != 2 || (x == 0 && y == 0) || (x == rows - 1 && y == columns - 1);
+            graph->cellNode[x * columns + y] = isNode ? nodeCount++ : -1;
+            if (isNode)
+                edgeCount += degree;
+        }
+    }
+
+    graph->nodeCount = nodeCount;
+    graph->edgeCount = edgeCount;
+    graph->nodeCell = malloc(sizeof(int) * nodeCount);
+    graph->edgeStart = malloc(sizeof(int) * (nodeCount + 1));
+    graph->edgeTarget = malloc(sizeof(int) * edgeCount);
+    graph->edgeWeight = malloc(sizeof(int) * edgeCount);
+    graph->edgeDirection = malloc(edgeCount);
+
+    // Edges: one corridor walk per opening of every node
+    int edge = 0;
+    for (int cell = 0; cell < (int) totalCells; cell++) {
+        int node = graph->cellNode[cell];
+        if (node < 0)
+            continue;
+        graph->nodeCell[node] = cell;
+        graph->edgeStart[node] = edge;
+        int openings = insideOpenings(matrix, rows, columns, cell / columns, cell % columns);
+        for (int direction = 0; direction < 4; direction++) {
+            if (openings & directionOpening[direction]) {
+                int length;
+                int target = walkCorridor(matrix, rows, columns, graph->cellNode, cell, direction, &length, NULL, NULL);
+                graph->edgeTarget[edge] = graph->cellNode[target];
+                graph->edgeWeight[edge] = length;
+                graph->edgeDirection[edge] = direction;
+                edge++;
+            }
+        }
+    }
+    graph->edgeStart[nodeCount] = edge;
+    return graph;
+}
+
+void freeJunctionGraph(JunctionGraph *graph) {
+    free(graph->nodeCell);
+    free(graph->cellNode);
+    free(graph->edgeStart);
+    free(graph->edgeTarget);
+    free(graph->edgeWeight);
+    free(graph->edgeDirection);
+    free(graph);
+}
+
+int solveJunctionGraph(const JunctionGraph *graph, int startNode, int endNode, int *edgePath, int *edgePathSize) {
+    /*
+    Subroutine that finds the shortest path between two nodes with Dijkstra's algorithm on the junction graph.
+    Inputs and constraints:
+        -graph: The junction graph.
+        -startNode, endNode: Nodes to join, graph->cellNode gives the node of a cell.
+        -edgePath: Array of at least nodeCount entries where the edges of the path are written in order, or NULL.
+        -edgePathSize: Pointer where the number of edges of the path is stored, or NULL.
+    Outputs:
+        -The number of moves of the path, or -1 if the nodes are not connected.
+    References:
+        -Dijkstra, E. W. (1959). A note on two problems in connexion with graphs. Numerische Mathematik, 1, 269-271.
+    */
+    int *distance = malloc(sizeof(int) * graph->nodeCount);
+    int *previousEdge = malloc(sizeof(int) * graph->nodeCount);
+    MinHeap heap = {0};
+
+    for (int node = 0; node < graph->nodeCount; node++)
+        distance[node] = -1;
+    distance[startNode] = 0;
+    previousEdge[startNode] = -1;
+    heapPush(&heap, 0, startNode);
+
+    while (heap.size > 0) {
+        HeapEntry entry = heapPop(&heap);
+        int node = entry.item;
+        if (entry.priority > distance[node])
+            continue;
+        if (node == endNode)
+            break;
+        for (int edge = graph->edgeStart[node]; edge < graph->edgeStart[node + 1]; edge++) {
+            int target = graph->edgeTarget[edge];
+            int newDistance = distance[node] + graph->edgeWeight[edge];
+            if (distance[target] < 0 || newDistance < distance[target]) {
+                distance[target] = newDistance;
+                previousEdge[target] = edge;
+                heapPush(&heap, newDistance, target);
+            }
+        }
+    }
+
+    int result = distance[endNode];
+    if (result >= 0 && (edgePath != NULL || edgePathSize != NULL)) {
+        // The edges are found from the end, the source of an edge is the node whose range contains it
+        int size = 0;
+        for (int node = endNode; node != startNode; size++) {
+            int edge = previousEdge[node];
+            if (edgePath != NULL)
+                edgePath[size] = edge;
+            int low = 0, high = graph->nodeCount - 1;
+            while (low < high) {
+                int middle = (low + high + 1) / 2;
+                if (graph->edgeStart[middle] <= edge) low = middle; else high = middle - 1;
+            }
+            node = low;
+        }
+        for (int i = 0; edgePath != NULL && i < size / 2; i++) {
+            int swap = edgePath[i];
+            edgePath[i] = edgePath[size - 1 - i];
+            edgePath[size - 1 - i] = swap;
+        }
+        if (edgePathSize != NULL)
+            *edgePathSize = size;
+    }
+
+    free(distance);
+    free(previousEdge);
+    freeHeap(&heap);
+    return result;
+}
+
+int expandJunctionPath(const JunctionGraph *graph, int **matrix, int startNode, const int *edgePath, int edgePathSize, int *pathX, int *pathY) {
+    /*
+    Subroutine that turns a path of the junction graph back into the cells of the laberynth.
+    Inputs and constraints:
+        -graph: The junction graph built from matrix.
+        -matrix: The laberynth.
+        -startNode: First node of the path.
+        -edgePath, edgePathSize: Edges of the path, as given by solveJunctionGraph.
+        -pathX, pathY: Arrays with room for every cell of the path (moves + 1).
+    Outputs:
+        -The number of cells written, the first one is the start node cell.
+    */
+    int cell = graph->nodeCell[startNode];
+    pathX[0] = cell / graph->columns;
+    pathY[0] = cell % graph->columns;
+    int size = 1;
+    for (int i = 0; i < edgePathSize; i++) {
+        int length;
+        cell = walkCorridor(matrix, graph->rows, graph->columns, graph->cellNode, cell, graph->edgeDirection[edgePath[i]], &length, pathX + size, pathY + size);
+        size += length;
+    }
+    return size;
+}
+
+void junctionGraphDemo(int rows, int columns, int queries) {
+    /*
+    Subroutine that builds the junction graph of a laberynth, compares its size with the grid and times the
+    solution of the entrance to exit path on it.
+    */
+    int **matrix = createMatrix(rows, columns);
+    CellLayout layout = createCellLayout(rowMajorLayout, rows, columns);
+    generateLaberynthCells(matrix[0], &layout, 1);
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    JunctionGraph *graph = buildJunctionGraph(matrix, rows, columns);
+    double buildSeconds = elapsedSeconds(start);
+    if (graph == NULL) {
+        printf("Too many cells for the junction graph: %lld\n", (long long) rows * columns);
+        freeMatrix(matrix, rows);
+        return;
+    }
+
+    int startNode = graph->cellNode[0];
+    int endNode = graph->cellNode[(size_t) rows * columns - 1];
+    int *edgePath = malloc(sizeof(int) * graph->nodeCount);
+    int edgePathSize = 0;
+    int moves = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int query = 0; query < queries; query++)
+        moves = solveJunctionGraph(graph, startNode, endNode, edgePath, &edgePathSize);
+    double solveSeconds = elapsedSeconds(start) / (queries > 0 ? queries : 1);
+    if (queries <= 0) // The path is still shown
+        moves = solveJunctionGraph(graph, startNode, endNode, edgePath, &edgePathSize);
+
+    int *pathX = malloc(sizeof(int) * (moves + 1));
+    int *pathY = malloc(sizeof(int) * (moves + 1));
+    int cells = expandJunctionPath(graph, matrix, startNode, edgePath, edgePathSize, pathX, pathY);
+
+    printf("Cells: %lld, nodes: %d, edges: %d\n", (long long) rows * columns, graph->nodeCount, graph->edgeCount / 2);
+    printf("Build: %.3f s, solve: %.6f s\n", buildSeconds, solveSeconds);
+    printf("Path: %d moves, %d edges, %d cells from (%d, %d) to (%d, %d)\n", moves, edgePathSize, cells, pathX[0], pathY[0], pathX[cells - 1], pathY[cells - 1]);
+
+    free(pathX);
+    free(pathY);
+    free(edgePath);
+    freeJunctionGraph(graph);
+    freeMatrix(matrix, rows);
+}
+
+/*******************************Tree Path Queries*******************************/
+/*
+Every laberynth built by createLaberynth is a spanning tree of the grid, so the path between two cells is unique
+and goes through their lowest common ancestor (LCA) once the tree is rooted at the entrance:
+    distance(a, b) = depth(a) + depth(b) - 2 * depth(lca(a, b))
+The LCA is the shallowest cell of the Euler tour between the first visits of a and b. The tour is cut in blocks
+of eulerBlockSize positions, a sparse table answers the minimum over whole blocks in O(1) and the two partial
+blocks at the ends are scanned, so every query costs a constant amount of work.
+*/
+
+#define eulerBlockShift 5
+#define eulerBlockSize (1 << eulerBlockShift)
+
+typedef struct {
+    int rows;
+    int columns;
+    int *depth;                     // Moves from the entrance
+    unsigned char *parentDirection; // Move that goes to the parent, 4 for the root
+    int *firstVisit;                // First position of every cell in the Euler tour
+    int *eulerCell;
+    int *eulerDepth;
+    int eulerSize;
+    int blockCount;
+    int levels;
+    int **blockMinimum;             // blockMinimum[k][b]: tour position of the shallowest cell of blocks b .. b + 2^k - 1
+} LaberynthTreeIndex;
+
+LaberynthTreeIndex *buildLaberynthTreeIndex(int **matrix, int rows, int columns) {
+    /*
+    Subroutine that roots the laberynth at the entrance and prepares the structures of the queries.
+    Inputs and constraints:
+        -matrix: Matrix with a perfect laberynth, solver marks are ignored. If the laberynth has loops the queries
+        answer with the paths of one of its spanning trees.
+        -rows, columns: Size of the matrix.
+    Outputs:
+        -The query index, it must be released with freeLaberynthTreeIndex. NULL if the tour of the cells does not
+        fit the int positions of the index.
+    */
+    size_t totalCells = (size_t) rows * columns;
+    if (2 * totalCells - 1 > INT_MAX)
+        return NULL;
+    LaberynthTreeIndex *index = malloc(sizeof(LaberynthTreeIndex));
+    index->rows = rows;
+    index->columns = columns;
+    index->depth = malloc(sizeof(int) * totalCells);
+    index->parentDirection = malloc(totalCells);
+    index->firstVisit = malloc(sizeof(int) * totalCells);
+    index->eulerCell = malloc(sizeof(int) * (2 * totalCells - 1));
+    index->eulerDepth = malloc(sizeof(int) * (2 * totalCells - 1));
+
+    for (size_t cell = 0; cell < totalCells; cell++)
+        index->depth[cell] = -1;
+
+    // Iterative depth first search, every cell is written to the tour when entered and after each child
+    int *stack = malloc(sizeof(int) * totalCells);
+    unsigned char *nextDirection = malloc(totalCells);
+    int stackSize = 0;
+    int eulerSize = 0;
+
+    stack[stackSize++] = 0;
+    nextDirection[0] = 0;
+    index->depth[0] = 0;
+    index->parentDirection[0] = 4;
+    index->firstVisit[0] = 0;
+    index->eulerCell[eulerSize] = 0;
+    index->eulerDepth[eulerSize++] = 0;
+
+    while (stackSize > 0) {
+        int cell = stack[stackSize - 1];
+        int x = cell / columns;
+        int y = cell % columns;
+        int openings = insideOpenings(matrix, rows, columns, x, y);
+        int direction = nextDirection[cell];
+        while (direction < 4 && (!(openings & directionOpening[direction])
+               || index->depth[cell + directionRowStep[direction] * columns + directionColumnStep[direction]] >= 0))
+            direction++;
+
+        if (direction == 4) { // Every child done, back to the parent
+            stackSize--;
+            if (stackSize > 0) {
+                int parent = stack[stackSize - 1];
+                index->eulerCell[eulerSize] = parent;
+                index->eulerDepth[eulerSize++] = index->depth[parent];
+            }
+            continue;
+        }
+
+        nextDirection[cell] = direction + 1;
+        int child = cell + directionRowStep[direction] * columns + directionColumnStep[direction];
+        index->depth[child] = index->depth[cell] + 1;
+        index->parentDirection[child] = directionOpposite[direction];
+        index->firstVisit[child] = eulerSize;
+        nextDirection[child] = 0;
+        stack[stackSize++] = child;
+        index->eulerCell[eulerSize] = child;
+        index->eulerDepth[eulerSize++] = index->depth[child];
+    }
+    free(stack);
+    free(nextDirection);
+    index->eulerSize = eulerSize;
+
+    // Sparse table over the blocks of the tour
+    index->blockCount = (eulerSize + eulerBlockSize - 1) >> eulerBlockShift;
+    index->levels = 1;
+    while ((1 << index->levels) <= index->blockCount)
+        index->levels++;
+    index->blockMinimum = malloc(sizeof(int *) * index->levels);
+    index->blockMinimum[0] = malloc(sizeof(int) * index->blockCount);
+    for (int block = 0; block < index->blockCount; block++) {
+        int best = block << eulerBlockShift;
+        int end = best + eulerBlockSize < eulerSize ? best + eulerBlockSize : eulerSize;
+        for (int position = best + 1; position < end; position++) {
+            if (index->eulerDepth[position] < index->eulerDepth[best])
+                best = position;
+        }
+        index->blockMinimum[0][block] = best;
+    }
+    for (int level = 1; level < index->levels; level++) {
+        int width = 1 << (level - 1);
+        index->blockMinimum[level] = malloc(sizeof(int) * index->blockCount);
+        for (int block = 0; block + 2 * width <= index->blockCount; block++) {
+            int left = index->blockMinimum[level - 1][block];
+            int right = index->blockMinimum[level - 1][block + width];
+            index->blockMinimum[level][block] = index->eulerDepth[right] < index->eulerDepth[left] ? right : left;
+        }
+    }
+    return index;
+}
+
+void freeLaberynthTreeIndex(LaberynthTreeIndex *index) {
+    for (int level = 0; level < index->levels; level++)
+        free(index->blockMinimum[level]);
+    free(index->blockMinimum);
+    free(index->depth);
+    free(index->parentDirection);
+    free(index->firstVisit);
+    free(index->eulerCell);
+    free(index->eulerDepth);
+    free(index);
+}
+
+int laberynthLowestCommonAncestor(const LaberynthTreeIndex *index, int firstCell, int secondCell) {
+    /*
+    Subroutine that finds the lowest common ancestor of two cells (x * columns + y).
+    */
+    int left = index->firstVisit[firstCell];
+    int right = index->firstVisit[secondCell];
+    if (left > right) {
+        int swap = left; left = right; right = swap;
+    }
+
+    int best = left;
+    int leftBlock = left >> eulerBlockShift;
+    int rightBlock = right >> eulerBlockShift;
+    if (leftBlock == rightBlock) {
+        for (int position = left + 1; position <= right; position++) {
+            if (index->eulerDepth[position] < index->eulerDepth[best])
+                best = position;
+        }
+        return index->eulerCell[best];
+    }
+
+    // Partial blocks at both ends
+    for (int position = left + 1; position < (leftBlock + 1) << eulerBlockShift; position++) {
+        if (index->eulerDepth[position] < index->eulerDepth[best])
+            best = position;
+    }
+    for (int position = rightBlock << eulerBlockShift; position <= right; position++) {
+        if (index->eulerDepth[position] < index->eulerDepth[best])
+            best = position;
+    }
+
+    // Whole blocks between them, two overlapping ranges of the sparse table
+    if (leftBlock + 1 < rightBlock) {
+        int first = leftBlock + 1;
+        int count = rightBlock - first;
+        int level = 31 - __builtin_clz(count);
+        int candidate = index->blockMinimum[level][first];
+        if (index->eulerDepth[candidate] < index->eulerDepth[best])
+            best = candidate;
+        candidate = index->blockMinimum[level][rightBlock - (1 << level)];
+        if (index->eulerDepth[candidate] < index->eulerDepth[best])
+            best = candidate;
+    }
+    return index->eulerCell[best];
+}
+
+int laberynthQueryDistance(const LaberynthTreeIndex *index, int startX, int startY, int endX, int endY) {
+    /*
+    Subroutine that gives the number of moves of the path between two cells in constant time.
+    Inputs and constraints:
+        -index: Index built with buildLaberynthTreeIndex.
+        -startX, startY, endX, endY: Cells of the laberynth.
+    Outputs:
+        -Number of moves between both cells.
+    */
+    int start = startX * index->columns + startY;
+    int end = endX * index->columns + endY;
+    int ancestor = laberynthLowestCommonAncestor(index, start, end);
+    return index->depth[start] + index->depth[end] - 2 * index->depth[ancestor];
+}
+
+int laberynthQueryPath(const LaberynthTreeIndex *index, int startX, int startY, int endX, int endY, int *pathX, int *pathY) {
+    /*
+    Subroutine that writes the cells of the path between two cells, climbing from both of them to their lowest
+    common ancestor.
+    Inputs and constraints:
+        -index: Index built with buildLaberynthTreeIndex.
+        -startX, startY, endX, endY: Cells of the laberynth.
+        -pathX, pathY: Arrays with room for laberynthQueryDistance + 1 cells.
+    Outputs:
+        -The number of cells written, from the start cell to the end cell.
+    */
+    int columns = index->columns;
+    int start = startX * columns + startY;
+    int end = endX * columns + endY;
+    int ancestor = laberynthLowestCommonAncestor(index, start, end);
+    int startMoves = index->depth[start] - index->depth[ancestor];
+    int size = startMoves + index->depth[end] - index->depth[ancestor] + 1;
+
+    // The start side is written forwards and the end side backwards
+    int cell = start;
+    for (int position = 0; position <= startMoves; position++) {
+        pathX[position] = cell / columns;
+        pathY[position] = cell % columns;
+        int direction = index->parentDirection[cell];
+        cell += directionRowStep[direction & 3] * columns + directionColumnStep[direction & 3];
+    }
+    cell = end;
+    for (int position = size - 1; position > startMoves; position--) {
+        pathX[position] = cell / columns;
+        pathY[position] = cell % columns;
+        int direction = index->parentDirection[cell];
+        cell += directionRowStep[direction] * columns + directionColumnStep[direction];
+    }
+    return size;
+}
+
+void treeQueriesDemo(int rows, int columns, int queries) {
+    /*
+    Subroutine that builds the query index of a laberynth and times random distance queries on it.
+    */
+    int **matrix = createMatrix(rows, columns);
+    CellLayout layout = createCellLayout(rowMajorLayout, rows, columns);
+    generateLaberynthCells(matrix[0], &layout, 1);
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    LaberynthTreeIndex *index = buildLaberynthTreeIndex(matrix, rows, columns);
+    double buildSeconds = elapsedSeconds(start);
+    if (index == NULL) {
+        printf("Too many cells for the query index: %lld\n", (long long) rows * columns);
+        freeMatrix(matrix, rows);
+        return;
+    }
+
+    unsigned long long randomState = seedRandom(2);
+    long long totalDistance = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int query = 0; query < queries; query++) {
+        totalDistance += laberynthQueryDistance(index, nextRandom(&randomState) % rows, nextRandom(&randomState) % columns,
+                                                nextRandom(&randomState) % rows, nextRandom(&randomState) % columns);
+    }
+    double querySeconds = elapsedSeconds(start);
+
+    int exitDistance = laberynthQueryDistance(index, 0, 0, rows - 1, columns - 1);
+    printf("Build: %.3f s, %d queries: %.3f s (%.0f ns each), average distance %.1f\n", buildSeconds, queries, querySeconds,
+           queries > 0 ? querySeconds * 1e9 / queries : 0.0, queries > 0 ? (double) totalDistance / queries : 0.0);
+    printf("Entrance to exit: %d moves\n", exitDistance);
+
+    freeLaberynthTreeIndex(index);
+    freeMatrix(matrix, rows);
+}
+
+/*******************************Binary Grid Files*******************************/
+/*
+Binary file shared by the laberynths and the per cell data computed from them:
+// BinaryGridHeader ; 32 bytes, magic "LABY", kind, bits per cell and size
+// payload ; rows * columns cells row by row, cells smaller than a byte are packed from the low bits up
+*/
+
+#define binaryGridVersion 1
+#define binaryLaberynth 1 // 4 bit nibbles with the openings
+#define binaryDistances 2 // 16 or 32 bit distances to the exit
+
+typedef struct {
+    char magic[4];
+    unsigned int version;
+    unsigned int kind;
+    unsigned int bitsPerCell;
+    unsigned int rows;
+    unsigned int columns;
+    unsigned long long payloadBytes;
+} BinaryGridHeader;
+
+bool writeBinaryGrid(const char *path, unsigned int kind, unsigned int bitsPerCell, int rows, int columns, const void *payload, size_t payloadBytes) {
+    /*
+    Subroutine that writes a header and its payload to a binary grid file.
+    Inputs and constraints:
+        -path: File to create or replace.
+        -kind: binaryLaberynth or binaryDistances.
+        -bitsPerCell: Size of each cell of the payload.
+        -rows, columns: Size of the grid.
+        -payload, payloadBytes: Cells of the grid.
+    Outputs:
+        -true if the whole file was written.
+    */
+    BinaryGridHeader header;
+    memcpy(header.magic, "LABY", 4);
+    header.version = binaryGridVersion;
+    header.kind = kind;
+    header.bitsPerCell = bitsPerCell;
+    header.rows = rows;
+    header.columns = columns;
+    header.payloadBytes = payloadBytes;
+
+    FILE *file = fopen(path, "wb");
+    if (file == NULL)
+        return false;
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1 && fwrite(payload, 1, payloadBytes, file) == payloadBytes;
+    return fclose(file) == 0 && written;
+}
+
+/*******************************Distance Field*******************************/
+/*
+The distance field gives, for every cell, the number of moves to the exit (rows - 1, columns - 1) used by
+randomMouse and tremaux. It is a breadth first search from the exit done level by level: every cell of the
+current level is expanded in parallel, each thread claims the unvisited neighbors with a compare and swap
+and keeps them in its own list, and the lists become the next level. The paths of a laberynth are long and
+narrow, so the levels smaller than parallelLevelSize are expanded by the calling thread alone.
+*/
+
+#define unreachableDistance 0xFFFFFFFFu
+#define parallelLevelSize 4096
+
+typedef struct DistanceFieldJob {
+    int **matrix;
+    int rows;
+    int columns;
+    unsigned int *distance;
+    pthread_barrier_t *barrier;
+    const int *level;        // Cells of the level being expanded
+    int levelSize;
+    unsigned int levelDistance;
+    int threadCount;
+    bool finished;
+} DistanceFieldJob;
+
+typedef struct {
+    DistanceFieldJob *job;
+    int thread;
+    int *next;               // Cells claimed for the next level
+    int nextSize;
+    int nextCapacity;
+} DistanceFieldWorker;
+
+int threadsAvailable(void) {
+    long processors = sysconf(_SC_NPROCESSORS_ONLN);
+    return processors > 0 ? (int) processors : 1;
+}
+
+void expandDistanceLevel(DistanceFieldWorker *worker, int first, int last) {
+    /*
+    Subroutine that expands the cells first .. last - 1 of the current level into the list of the worker.
+    */
+    DistanceFieldJob *job = worker->job;
+    int columns = job->columns;
+    unsigned int nextDistance = job->levelDistance + 1;
+
+    for (int position = first; position < last; position++) {
+        int cell = job->level[position];
+        int openings = insideOpenings(job->matrix, job->rows, columns, cell / columns, cell % columns);
+        for (int direction = 0; direction < 4; direction++) {
+            if (!(openings & directionOpening[direction]))
+                continue;
+            int neighbor = cell + directionRowStep[direction] * columns + directionColumnStep[direction];
+            unsigned int expected = unreachableDistance;
+            if (job->distance[neighbor] == unreachableDistance
+                && __atomic_compare_exchange_n(&job->distance[neighbor], &expected, nextDistance, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                if (worker->nextSize == worker->nextCapacity) {
+                    worker->nextCapacity = worker->nextCapacity > 0 ? worker->nextCapacity * 2 : 1024;
+                    worker->next = realloc(worker->next, sizeof(int) * worker->nextCapacity);
+                }
+                worker->next[worker->nextSize++] = neighbor;
+            }
+        }
+    }
+}
+
+void expandDistanceSlice(DistanceFieldWorker *worker) {
+    DistanceFieldJob *job = worker->job;
+    long long first = (long long) job->levelSize * worker->thread / job->threadCount;
+    long long last = (long long) job->levelSize * (worker->thread + 1) / job->threadCount;
+    expandDistanceLevel(worker, (int) first, (int) last);
+}
+
+void *distanceFieldThread(void *argument) {
+    /*
+    Subroutine run by the helper threads: expand their slice of every wide level until the search finishes.
+    */
+    DistanceFieldWorker *worker = argument;
+    DistanceFieldJob *job = worker->job;
+    while (true) {
+        pthread_barrier_wait(job->barrier); // Level published
+        if (job->finished)
+            break;
+        expandDistanceSlice(worker);
+        pthread_barrier_wait(job->barrier); // Level done
+    }
+    return NULL;
+}
+
+unsigned int *computeDistanceFieldWithOptions(int **matrix, int rows, int columns, int threadCount, const AllocationOptions *options) {
+    /*
+    Subroutine that computes the number of moves from every cell to the exit.
+    Inputs and constraints:
+        -matrix: Matrix with the laberynth, solver marks are ignored.
+        -rows, columns: Size of the matrix.
+        -threadCount: Threads used for the wide levels, 0 uses one per processor.
+        -options: Huge pages and NUMA first touch of the distances as in createMatrixWithOptions, NULL for malloc.
+    Outputs:
+        -Array of rows * columns distances in row major order, unreachableDistance for the cells that cannot
+        reach the exit, or NULL if there is no memory. It must be released with releaseLargeBlock.
+    */
+    size_t totalCells = (size_t) rows * columns;
+    size_t stripBytes = 0;
+    if (options != NULL && options->touchThreads > 0)
+        stripBytes = sizeof(unsigned int) * (size_t) columns * matrixStripRows(rows, options->touchThreads);
+    unsigned int *distance = allocateLargeBlock(sizeof(unsigned int) * totalCells, stripBytes, options);
+    if (distance == NULL)
+        return NULL;
+    for (size_t cell = 0; cell < totalCells; cell++)
+        distance[cell] = unreachableDistance;
+
+    if (threadCount <= 0)
+        threadCount = threadsAvailable();
+
+    pthread_barrier_t barrier;
+    pthread_barrier_init(&barrier, NULL, threadCount);
+    DistanceFieldJob job = {matrix, rows, columns, distance, &barrier, NULL, 0, 0, threadCount, false};
+    DistanceFieldWorker *workers = calloc(threadCount, sizeof(DistanceFieldWorker));
+    pthread_t *threads = malloc(sizeof(pthread_t) * threadCount);
+    for (int thread = 0; thread < threadCount; thread++) {
+        workers[thread].job = &job;
+        workers[thread].thread = thread;
+        if (thread > 0)
+            pthread_create(&threads[thread], NULL, distanceFieldThread, &workers[thread]);
+    }
+
+    int exitCell = (rows - 1) * columns + columns - 1;
+    int *level = malloc(sizeof(int));
+    int levelCapacity = 1;
+    level[0] = exitCell;
+    distance[exitCell] = 0;
+    job.level = level;
+    job.levelSize = 1;
+
+    while (job.levelSize > 0) {
+        if (threadCount == 1 || job.levelSize < parallelLevelSize) {
+            expandDistanceLevel(&workers[0], 0, job.levelSize);
+        } else {
+            pthread_barrier_wait(&barrier);
+            expandDistanceSlice(&workers[0]);
+            pthread_barrier_wait(&barrier);
+        }
+
+        // The lists of every thread become the next level
+        int nextSize = 0;
+        for (int thread = 0; thread < threadCount; thread++)
+            nextSize += workers[thread].nextSize;
+        if (nextSize > levelCapacity) {
+            levelCapacity = nextSize;
+            level = realloc(level, sizeof(int) * levelCapacity);
+        }
+        nextSize = 0;
+        for (int thread = 0; thread < threadCount; thread++) {
+            if (workers[thread].nextSize > 0) // A worker that found nothing may not have a list yet
+                memcpy(level + nextSize, workers[thread].next, sizeof(int) * workers[thread].nextSize);
+            nextSize += workers[thread].nextSize;
+            workers[thread].nextSize = 0;
+        }
+        job.level = level;
+        job.levelSize = nextSize;
+        job.levelDistance++;
+    }
+
+    job.finished = true;
+    if (threadCount > 1)
+        pthread_barrier_wait(&barrier);
+    for (int thread = 0; thread < threadCount; thread++) {
+        if (thread > 0)
+            pthread_join(threads[thread], NULL);
+        free(workers[thread].next);
+    }
+    pthread_barrier_destroy(&barrier);
+    free(threads);
+    free(workers);
+    free(level);
+    return distance;
+}
+
+unsigned int *computeDistanceField(int **matrix, int rows, int columns, int threadCount) {
+    return computeDistanceFieldWithOptions(matrix, rows, columns, threadCount, NULL);
+}
+
+unsigned int maximumDistance(const unsigned int *distance, size_t totalCells) {
+    unsigned int maximum = 0;
+    for (size_t cell = 0; cell < totalCells; cell++) {
+        if (distance[cell] != unreachableDistance && distance[cell] > maximum)
+            maximum = distance[cell];
+    }
+    return maximum;
+}
+
+bool saveDistanceFieldBinary(const char *path, const unsigned int *distance, int rows, int columns) {
+    /*
+    Subroutine that exports a distance field as a binary grid file. The distances are stored with 16 bits when
+    the longest one fits (unreachable cells become 0xFFFF), and with 32 bits otherwise.
+    Inputs and constraints:
+        -path: File to create.
+        -distance: Distance field of computeDistanceField.
+        -rows, columns: Size of the field.
+    Outputs:
+        -true if the file was written.
+    */
+    size_t totalCells = (size_t) rows * columns;
+    if (maximumDistance(distance, totalCells) >= 0xFFFF)
+        return writeBinaryGrid(path, binaryDistances, 32, rows, columns, distance, sizeof(unsigned int) * totalCells);
+
+    unsigned short *shortDistance = malloc(sizeof(unsigned short) * totalCells);
+    for (size_t cell = 0; cell < totalCells; cell++)
+        shortDistance[cell] = distance[cell] == unreachableDistance ? 0xFFFF : (unsigned short) distance[cell];
+    bool written = writeBinaryGrid(path, binaryDistances, 16, rows, columns, shortDistance, sizeof(unsigned short) * totalCells);
+    free(shortDistance);
+    return written;
+}
+
+bool saveDistanceFieldPGM(const char *path, const unsigned int *distance, int rows, int columns) {
+    /*
+    Subroutine that exports a distance field as a grayscale heatmap (binary PGM, one pixel per cell). The exit is
+    black, the farthest cell is white and the unreachable cells are white too.
+    Inputs and constraints:
+        -path: File to create.
+        -distance: Distance field of computeDistanceField.
+        -rows, columns: Size of the field.
+    Outputs:
+        -true if the file was written.
+    References:
+        -Poskanzer, J. (2016). PGM Format Specification. https://netpbm.sourceforge.net/doc/pgm.html
+    */
+    FILE *file = fopen(path, "wb");
+    if (file == NULL)
+        return false;
+    unsigned int maximum = maximumDistance(distance, (size_t) rows * columns);
+    if (maximum == 0)
+        maximum = 1;
+
+    fprintf(file, "P5\n%d %d\n255\n", columns, rows);
+    unsigned char *row = malloc(columns);
+    bool written = true;
+    for (int x = 0; x < rows && written; x++) {
+        for (int y = 0; y < columns; y++) {
+            unsigned int value = distance[(size_t) x * columns + y];
+            row[y] = value == unreachableDistance ? 255 : (unsigned char) ((unsigned long long) value * 255 / maximum);
+        }
+        written = fwrite(row, 1, columns, file) == (size_t) columns;
+    }
+    free(row);
+    return fclose(file) == 0 && written;
+}
+
+void distanceFieldDemo(int rows, int columns, int threadCount, const char *binaryPath, const char *heatmapPath) {
+    /*
+    Subroutine that times the distance field of a laberynth and exports it.
+    */
+    int **matrix = createMatrix(rows, columns);
+    CellLayout layout = createCellLayout(rowMajorLayout, rows, columns);
+    generateLaberynthCells(matrix[0], &layout, 1);
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    unsigned int *distance = computeDistanceField(matrix, rows, columns, threadCount);
+    double seconds = elapsedSeconds(start);
+
+    printf("Distance field of %d x %d cells: %.3f s, entrance at %u moves, farthest cell at %u moves\n", rows, columns,
+           seconds, distance[0], maximumDistance(distance, (size_t) rows * columns));
+    if (binaryPath != NULL && !saveDistanceFieldBinary(binaryPath, distance, rows, columns))
+        printf("Could not write %s\n", binaryPath);
+    if (heatmapPath != NULL && !saveDistanceFieldPGM(heatmapPath, distance, rows, columns))
+        printf("Could not write %s\n", heatmapPath);
+
+    releaseLargeBlock(distance);
+    freeMatrix(matrix, rows);
+}
+
+/*******************************Dynamic Path Index*******************************/
+/*
+When a single wall changes only the cells whose distance to the exit depended on it need new distances:
+// Wall removed ; The far side may get closer, the improvement spreads as a breadth first search that stops at
+//                the cells that do not improve.
+// Wall added ; The cells that lost their only neighbor one move closer to the exit are collected level by
+//              level, then they get new distances from the cells around them with Dijkstra's algorithm.
+The entrance to exit path is cached and only walked again when one of its cells or moves changed.
+*/
+
+typedef struct {
+    int **matrix;
+    int rows;
+    int columns;
+    unsigned int *distance;  // Moves to the exit, as computeDistanceField
+    int *path;               // Cells from the entrance to the exit, x * columns + y
+    int pathSize;            // 0 if the exit cannot be reached from the entrance
+    unsigned char *onPath;
+    unsigned char *affected;
+    int *queue;
+    MinHeap heap;
+    bool pathDirty;
+    long long lastChangedCells;
+} DynamicPathIndex;
+
+void addBarrierCell(int **matrix, int firstX, int firstY, int secondX, int secondY) {
+    /*
+    Subroutine that puts back the barrier between two adjacent cells, undoing removeBarrierCell.
+    Inputs and constraints:
+        -matrix: The laberynth, the barrier must be removed.
+        -firstX, firstY, secondX, secondY: Two adjacent cells.
+    Outputs:
+        -The matrix with the barrier between both cells.
+    */
+    if (firstX != secondX) {
+        if (firstX > secondX) {
+            matrix[firstX][firstY] = matrix[firstX][firstY] - 8;
+            matrix[secondX][secondY] = matrix[secondX][secondY] - 2;
+        } else {
+            matrix[firstX][firstY] = matrix[firstX][firstY] - 2;
+            matrix[secondX][secondY] = matrix[secondX][secondY] - 8;
+        }
+    } else {
+        if (firstY > secondY) {
+            matrix[firstX][firstY] = matrix[firstX][firstY] - 4;
+            matrix[secondX][secondY] = matrix[secondX][secondY] - 1;
+        } else {
+            matrix[firstX][firstY] = matrix[firstX][firstY] - 1;
+            matrix[secondX][secondY] = matrix[secondX][secondY] - 4;
+        }
+    }
+}
+
+void setDynamicDistance(DynamicPathIndex *index, int cell, unsigned int distance) {
+    if (index->onPath[cell] || cell == 0) // The entrance decides if there is a path at all
+        index->pathDirty = true;
+    index->distance[cell] = distance;
+    index->lastChangedCells++;
+}
+
+void rebuildDynamicPath(DynamicPathIndex *index) {
+    /*
+    Subroutine that walks from the entrance to the exit always moving to a neighbor one move closer to the exit.
+    */
+    int columns = index->columns;
+    for (int position = 0; position < index->pathSize; position++)
+        index->onPath[index->path[position]] = 0;
+    index->pathSize = 0;
+    index->pathDirty = false;
+    if (index->distance[0] == unreachableDistance)
+        return;
+
+    int cell = 0;
+    index->path[index->pathSize++] = cell;
+    index->onPath[cell] = 1;
+    while (index->distance[cell] > 0) {
+        int openings = insideOpenings(index->matrix, index->rows, columns, cell / columns, cell % columns);
+        for (int direction = 0; direction < 4; direction++) {
+            int neighbor = cell + directionRowStep[direction] * columns + directionColumnStep[direction];
+            if ((openings & directionOpening[direction]) && index->distance[neighbor] == index->distance[cell] - 1) {
+                cell = neighbor;
+                break;
+            }
+        }
+        index->path[index->pathSize++] = cell;
+        index->onPath[cell] = 1;
+    }
+}
+
+DynamicPathIndex *createDynamicPathIndex(int **matrix, int rows, int columns) {
+    /*
+    Subroutine that computes the distance field and the entrance to exit path of a laberynth that will be edited.
+    Inputs and constraints:
+        -matrix: The laberynth, the index keeps using it, so every edit must go through dynamicToggleWall.
+        -rows, columns: Size of the matrix.
+    Outputs:
+        -The index, it must be released with freeDynamicPathIndex.
+    */
+    DynamicPathIndex *index = calloc(1, sizeof(DynamicPathIndex));
+    size_t totalCells = (size_t) rows * columns;
+    index->matrix = matrix;
+    index->rows = rows;
+    index->columns = columns;
+    index->distance = computeDistanceField(matrix, rows, columns, 0);
+    index->path = malloc(sizeof(int) * totalCells);
+    index->onPath = calloc(totalCells, 1);
+    index->affected = calloc(totalCells, 1);
+    index->queue = malloc(sizeof(int) * totalCells);
+    rebuildDynamicPath(index);
+    return index;
+}
+
+void freeDynamicPathIndex(DynamicPathIndex *index) {
+    releaseLargeBlock(index->distance);
+    free(index->path);
+    free(index->onPath);
+    free(index->affected);
+    free(index->queue);
+    freeHeap(&index->heap);
+    free(index);
+}
+
+void spreadDistanceDecrease(DynamicPathIndex *index, int cell) {
+    /*
+    Subroutine that spreads the new, smaller distance of a cell to its neighbors until no cell improves.
+    */
+    int columns = index->columns;
+    int queueStart = 0;
+    int queueEnd = 0;
+    index->queue[queueEnd++] = cell;
+    while (queueStart < queueEnd) {
+        cell = index->queue[queueStart++];
+        unsigned int nextDistance = index->distance[cell] + 1;
+        int openings = insideOpenings(index->matrix, index->rows, columns, cell / columns, cell % columns);
+        for (int direction = 0; direction < 4; direction++) {
+            int neighbor = cell + directionRowStep[direction] * columns + directionColumnStep[direction];
+            if ((openings & directionOpening[direction]) && index->distance[neighbor] > nextDistance) {
+                setDynamicDistance(index, neighbor, nextDistance);
+                index->queue[queueEnd++] = neighbor;
+            }
+        }
+    }
+}
+
+bool hasCloserNeighbor(DynamicPathIndex *index, int cell) {
+    /*
+    Subroutine that tells if a cell still has a neighbor one move closer to the exit that is not affected.
+    */
+    int columns = index->columns;
+    int openings = insideOpenings(index->matrix, index->rows, columns, cell / columns, cell % columns);
+    for (int direction = 0; direction < 4; direction++) {
+        int neighbor = cell + directionRowStep[direction] * columns + directionColumnStep[direction];
+        if ((openings & directionOpening[direction]) && !index->affected[neighbor]
+            && index->distance[neighbor] + 1 == index->distance[cell])
+            return true;
+    }
+    return false;
+}
+
+void repairDistanceIncrease(DynamicPathIndex *index, int cell) {
+    /*
+    Subroutine that finds the cells whose distance grows because cell lost its way to the exit, and gives
+    them their new distances.
+    */
+    int columns = index->columns;
+    if (index->distance[cell] == unreachableDistance || index->distance[cell] == 0 || hasCloserNeighbor(index, cell))
+        return;
+
+    // Affected cells, level by level: a cell is affected when all its closer neighbors are
+    int queueEnd = 0;
+    index->affected[cell] = 1;
+    index->queue[queueEnd++] = cell;
+    for (int queueStart = 0; queueStart < queueEnd; queueStart++) {
+        int current = index->queue[queueStart];
+        int openings = insideOpenings(index->matrix, index->rows, columns, current / columns, current % columns);
+        for (int direction = 0; direction < 4; direction++) {
+            int neighbor = current + directionRowStep[direction] * columns + directionColumnStep[direction];
+            if ((openings & directionOpening[direction]) && !index->affected[neighbor]
+                && index->distance[neighbor] == index->distance[current] + 1 && !hasCloserNeighbor(index, neighbor)) {
+                index->affected[neighbor] = 1;
+                index->queue[queueEnd++] = neighbor;
+            }
+        }
+    }
+
+    // New distances: from the best unaffected neighbor, then Dijkstra inside the affected cells
+    for (int position = 0; position < queueEnd; position++) {
+        int current = index->queue[position];
+        unsigned int best = unreachableDistance;
+        int openings = insideOpenings(index->matrix, index->rows, columns, current / columns, current % columns);
+        for (int direction = 0; direction < 4; direction++) {
+            int neighbor = current + directionRowStep[direction] * columns + directionColumnStep[direction];
+            if ((openings & directionOpening[direction]) && !index->affected[neighbor]
+                && index->distance[neighbor] != unreachableDistance && index->distance[neighbor] + 1 < best)
+                best = index->distance[neighbor] + 1;
+        }
+        setDynamicDistance(index, current, best);
+        if (best != unreachableDistance)
+            heapPush(&index->heap, best, current);
+    }
+    while (index->heap.size > 0) {
+        HeapEntry entry = heapPop(&index->heap);
+        int current = entry.item;
+        if (entry.priority > index->distance[current])
+            continue;
+        unsigned int nextDistance = index->distance[current] + 1;
+        int openings = insideOpenings(index->matrix, index->rows, columns, current / columns, current % columns);
+        for (int direction = 0; direction < 4; direction++) {
+            int neighbor = current + directionRowStep[direction] * columns + directionColumnStep[direction];
+            if ((openings & directionOpening[direction]) && index->affected[neighbor] && index->distance[neighbor] > nextDistance) {
+                setDynamicDistance(index, neighbor, nextDistance);
+                heapPush(&index->heap, nextDistance, neighbor);
+            }
+        }
+    }
+
+    for (int position = 0; position < queueEnd; position++)
+        index->affected[index->queue[position]] = 0;
+}
+
+bool dynamicToggleWall(DynamicPathIndex *index, int firstX, int firstY, int secondX, int secondY) {
+    /*
+    Subroutine that removes the barrier between two adjacent cells if it is there, or puts it back if it is not,
+    and updates the distances and the path.
+    Inputs and constraints:
+        -index: Index of the laberynth.
+        -firstX, firstY, secondX, secondY: Two adjacent cells.
+    Outputs:
+        -true if the cells are connected after the edit. index->lastChangedCells tells how many distances changed.
+    */
+    int **matrix = index->matrix;
+    int columns = index->columns;
+    int first = firstX * columns + firstY;
+    int second = secondX * columns + secondY;
+    int direction = secondX < firstX ? 0 : secondX > firstX ? 1 : secondY < firstY ? 2 : 3;
+    bool open = !(matrix[firstX][firstY] & directionOpening[direction]);
+
+    index->lastChangedCells = 0;
+    if (index->onPath[first] && index->onPath[second])
+        index->pathDirty = true;
+
+    if (open) {
+        removeBarrierCell(matrix, firstX, firstY, secondX, secondY);
+        if (index->distance[second] != unreachableDistance && index->distance[second] + 1 < index->distance[first]) {
+            setDynamicDistance(index, first, index->distance[second] + 1);
+            spreadDistanceDecrease(index, first);
+        } else if (index->distance[first] != unreachableDistance && index->distance[first] + 1 < index->distance[second]) {
+            setDynamicDistance(index, second, index->distance[first] + 1);
+            spreadDistanceDecrease(index, second);
+        }
+    } else {
+        addBarrierCell(matrix, firstX, firstY, secondX, secondY);
+        if (index->distance[first] > index->distance[second])
+            repairDistanceIncrease(index, first);
+        else if (index->distance[second] > index->distance[first])
+            repairDistanceIncrease(index, second);
+    }
+
+    if (index->pathDirty)
+        rebuildDynamicPath(index);
+    return open;
+}
+
+void dynamicPathDemo(int rows, int columns, int edits) {
+    /*
+    Subroutine that toggles random walls of a laberynth, times the updates and checks the last distance field
+    against a full computation.
+    */
+    int **matrix = createMatrix(rows, columns);
+    CellLayout layout = createCellLayout(rowMajorLayout, rows, columns);
+    generateLaberynthCells(matrix[0], &layout, 1);
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    DynamicPathIndex *index = createDynamicPathIndex(matrix, rows, columns);
+    double buildSeconds = elapsedSeconds(start);
+    printf("Full computation: %.3f s, path of %d cells\n", buildSeconds, index->pathSize);
+
+    unsigned long long randomState = seedRandom(3);
+    long long changedCells = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int edit = 0; edit < edits; edit++) {
+        int x = nextRandom(&randomState) % rows;
+        int y = nextRandom(&randomState) % columns;
+        bool vertical = nextRandom(&randomState) % 2;
+        if ((vertical && x + 1 >= rows) || (!vertical && y + 1 >= columns))
+            continue;
+        dynamicToggleWall(index, x, y, vertical ? x + 1 : x, vertical ? y : y + 1);
+        changedCells += index->lastChangedCells;
+    }
+    double editSeconds = elapsedSeconds(start);
+    printf("%d edits: %.3f s (%.1f us each), %.1f distances changed per edit, path of %d cells\n", edits, editSeconds,
+           editSeconds * 1e6 / edits, (double) changedCells / edits, index->pathSize);
+
+    unsigned int *distance = computeDistanceField(matrix, rows, columns, 0);
+    size_t differentCells = 0;
+    for (size_t cell = 0; cell < (size_t) rows * columns; cell++) {
+        if (distance[cell] != index->distance[cell])
+            differentCells++;
+    }
+    printf("Cells different from a full computation: %zu\n", differentCells);
+
+    releaseLargeBlock(distance);
+    freeDynamicPathIndex(index);
+    freeMatrix(matrix, rows);
+}
+
+/*******************************Laberynth Files*******************************/
+
+bool saveLaberynthBinary(const char *path, int **matrix, int rows, int columns) {
+    /*
+    Subroutine that saves a laberynth as a binary grid file of 4 bit nibbles (nibble packing).
+    Inputs and constraints:
+        -path: File to create.
+        -matrix, rows, columns: The laberynth, solver marks are dropped.
+    Outputs:
+        -true if the file was written.
+    */
+    PackedLaberynth *packed = packLaberynth(matrix, rows, columns, nibblePacking);
+    bool written = writeBinaryGrid(path, binaryLaberynth, 4, rows, columns, packed->data, packed->bytes);
+    freePackedLaberynth(packed);
+    return written;
+}
+
+PackedLaberynth *mapLaberynthBinary(const char *path) {
+    /*
+    Subroutine that maps a binary laberynth file in memory without copying it, the cells are read straight from
+    the page cache.
+    Inputs and constraints:
+        -path: File written by saveLaberynthBinary.
+    Outputs:
+        -A read only nibble packed laberynth, or NULL if the file cannot be mapped or is not a laberynth.
+        It must be released with freePackedLaberynth.
+    */
+    int file = open(path, O_RDONLY);
+    if (file < 0)
+        return NULL;
+    struct stat information;
+    if (fstat(file, &information) != 0 || (size_t) information.st_size < sizeof(BinaryGridHeader)) {
+        close(file);
+        return NULL;
+    }
+    void *mapping = mmap(NULL, information.st_size, PROT_READ, MAP_SHARED, file, 0);
+    close(file);
+    if (mapping == MAP_FAILED)
+        return NULL;
+
+    const BinaryGridHeader *header = mapping;
+    size_t totalCells = (size_t) header->rows * header->columns;
+    if (memcmp(header->magic, "LABY", 4) != 0 || header->kind != binaryLaberynth || header->bitsPerCell != 4
+        || header->rows == 0 || header->columns == 0 || header->payloadBytes != (totalCells + 1) / 2
+        || (size_t) information.st_size < sizeof(BinaryGridHeader) + header->payloadBytes) {
+        munmap(mapping, information.st_size);
+        return NULL;
+    }
+    madvise(mapping, information.st_size, MADV_SEQUENTIAL);
+
+    PackedLaberynth *packed = malloc(sizeof(PackedLaberynth));
+    packed->mode = nibblePacking;
+    packed->rows = header->rows;
+    packed->columns = header->columns;
+    packed->bytes = header->payloadBytes;
+    packed->data = (unsigned char *) mapping + sizeof(BinaryGridHeader);
+    packed->mapping = mapping;
+    packed->mappingBytes = information.st_size;
+    packed->entranceOpen = packedBits(packed, 0) & aboveOpening;
+    return packed;
+}
+
+/*******************************Laberynth Analytics*******************************/
+/*
+The local metrics come out of one pass over the nibbles, split in row strips between threads:
+// Dead ends ; 1 opening inside the laberynth
+// Corridors ; 2 openings, every run of corridor cells between two other cells is measured once, walking it
+//             from its end with the smallest index
+// Junctions ; 3 or 4 openings
+The solution is the only metric that is not local, and it is a second, serial pass on the calling thread after
+its strip: a wall follower goes from the entrance to the exit keeping only a stack of its moves, the moves that go
+back cancel the last one, so no per cell memory is needed. It makes up to two moves per cell in the part of the
+laberynth it explores, so on large laberynths it can take longer than the strips.
+*/
+
+#define corridorHistogramSize 24
+
+const unsigned char openingCount[16] = {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4};
+// Turns of the wall follower, directions in the order Up, Down, Left, Right
+const int rightTurn[] = {3, 2, 0, 1};
+const int leftTurn[] = {2, 3, 1, 0};
+
+typedef struct {
+    long long cells;
+    long long deadEnds;
+    long long corridorCells;
+    long long junctions;
+    long long corridors;
+    long long longestCorridor;
+    long long corridorHistogram[corridorHistogramSize]; // Bucket i: lengths in [2^i - 1, 2^(i + 1) - 1)
+    long long solutionMoves;                            // -1 if the exit was not reached
+    double seconds;
+} LaberynthAnalytics;
+
+typedef struct {
+    const PackedLaberynth *packed;
+    int firstRow;
+    int lastRow;
+    LaberynthAnalytics result;
+} AnalyticsStrip;
+
+static inline int packedInsideOpenings(const PackedLaberynth *packed, int x, int y) {
+    int openings = packed->mode == nibblePacking ? packedBits(packed, (size_t) x * packed->columns + y) : packedCellValue(packed, x, y);
+    if (x == 0) openings &= ~aboveOpening;
+    if (x == packed->rows - 1) openings &= ~belowOpening;
+    if (y == 0) openings &= ~leftOpening;
+    if (y == packed->columns - 1) openings &= ~rightOpening;
+    return openings;
+}
+
+void *analyticsStripThread(void *argument) {
+    /*
+    Subroutine that counts the cells of a strip of rows and measures the corridors that start in it.
+    */
+    AnalyticsStrip *strip = argument;
+    const PackedLaberynth *packed = strip->packed;
+    LaberynthAnalytics *result = &strip->result;
+    int columns = packed->columns;
+
+    for (int x = strip->firstRow; x < strip->lastRow; x++) {
+        for (int y = 0; y < columns; y++) {
+            int openings = packedInsideOpenings(packed, x, y);
+            int degree = openingCount[openings];
+            result->cells++;
+            if (degree == 2) {
+                result->corridorCells++;
+                continue;
+            }
+            if (degree == 1)
+                result->deadEnds++;
+            else if (degree > 2)
+                result->junctions++;
+
+            // Corridors leaving this cell
+            long long start = (long long) x * columns + y;
+            for (int firstDirection = 0; firstDirection < 4; firstDirection++) {
+                if (!(openings & directionOpening[firstDirection]))
+                    continue;
+                int direction = firstDirection;
+                int currentX = x + directionRowStep[direction];
+                int currentY = y + directionColumnStep[direction];
+                long long length = 0;
+                int currentOpenings = packedInsideOpenings(packed, currentX, currentY);
+                while (openingCount[currentOpenings] == 2) {
+                    length++;
+                    currentOpenings &= ~directionOpening[directionOpposite[direction]];
+                    for (direction = 0; !(currentOpenings & directionOpening[direction]); direction++);
+                    currentX += directionRowStep[direction];
+                    currentY += directionColumnStep[direction];
+                    currentOpenings = packedInsideOpenings(packed, currentX, currentY);
+                }
+                long long end = (long long) currentX * columns + currentY;
+                // Counted from the end with the smallest index, a loop back to the same cell from its first opening
+                if (start < end || (start == end && firstDirection < directionOpposite[direction])) {
+                    int bucket = 63 - __builtin_clzll((unsigned long long) length + 1);
+                    result->corridors++;
+                    result->corridorHistogram[bucket < corridorHistogramSize ? bucket : corridorHistogramSize - 1]++;
+                    if (length > result->longestCorridor)
+                        result->longestCorridor = length;
+                }
+            }
+        }
+    }
+    return NULL;
+}
+
+long long wallFollowerSolutionMoves(const PackedLaberynth *packed) {
+    /*
+    Subroutine that follows the right hand wall from the entrance to the exit and returns the moves of the path
+    without the dead ends. In a perfect laberynth that is the only solution.
+    Outputs:
+        -Moves of the solution, or -1 if the walk came back to the entrance without finding the exit.
+    */
+    int rows = packed->rows;
+    int columns = packed->columns;
+    long long capacity = 1024;
+    long long stackSize = 0;
+    unsigned char *stack = malloc(capacity);
+    int x = 0;
+    int y = 0;
+    int heading = 1; // Entering from above
+    long long maxMoves = 4 * (long long) rows * columns; // Each side of each opening is followed once at most
+
+    for (long long moves = 0; x != rows - 1 || y != columns - 1; moves++) {
+        int openings = packedInsideOpenings(packed, x, y);
+        if (openings == 0 || moves == maxMoves) {
+            stackSize = -1; // The exit is not in the part of the entrance
+            break;
+        }
+        int turns[4] = {rightTurn[heading], heading, leftTurn[heading], directionOpposite[heading]};
+        int direction = 0;
+        for (int turn = 0; turn < 4; turn++) {
+            if (openings & directionOpening[turns[turn]]) {
+                direction = turns[turn];
+                break;
+            }
+        }
+
+        if (stackSize > 0 && stack[stackSize - 1] == directionOpposite[direction]) {
+            stackSize--;
+        } else {
+            if (stackSize == capacity) {
+                capacity *= 2;
+                stack = realloc(stack, capacity);
+            }
+            stack[stackSize++] = direction;
+        }
+        x += directionRowStep[direction];
+        y += directionColumnStep[direction];
+        heading = direction;
+    }
+    free(stack);
+    return stackSize;
+}
+
+LaberynthAnalytics analyzeLaberynth(const PackedLaberynth *packed, int threadCount) {
+    /*
+    Subroutine that computes the metrics of a packed (or mapped) laberynth. The strips are analyzed in parallel,
+    the solution length is a separate serial walk while the other strips finish.
+    Inputs and constraints:
+        -packed: The laberynth, in any packing.
+        -threadCount: Number of row strips analyzed in parallel, 0 uses one per processor.
+    Outputs:
+        -The metrics of the laberynth.
+    */
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    if (threadCount <= 0)
+        threadCount = threadsAvailable();
+    if (threadCount > packed->rows)
+        threadCount = packed->rows;
+
+    AnalyticsStrip *strips = calloc(threadCount, sizeof(AnalyticsStrip));
+    pthread_t *threads = malloc(sizeof(pthread_t) * threadCount);
+    for (int thread = 0; thread < threadCount; thread++) {
+        strips[thread].packed = packed;
+        strips[thread].firstRow = (int) ((long long) packed->rows * thread / threadCount);
+        strips[thread].lastRow = (int) ((long long) packed->rows * (thread + 1) / threadCount);
+        if (thread > 0)
+            pthread_create(&threads[thread], NULL, analyticsStripThread, &strips[thread]);
+    }
+    analyticsStripThread(&strips[0]);
+    long long solutionMoves = wallFollowerSolutionMoves(packed);
+
+    LaberynthAnalytics analytics;
+    memset(&analytics, 0, sizeof(analytics));
+    for (int thread = 0; thread < threadCount; thread++) {
+        if (thread > 0)
+            pthread_join(threads[thread], NULL);
+        LaberynthAnalytics *strip = &strips[thread].result;
+        analytics.cells += strip->cells;
+        analytics.deadEnds += strip->deadEnds;
+        analytics.corridorCells += strip->corridorCells;
+        analytics.junctions += strip->junctions;
+        analytics.corridors += strip->corridors;
+        if (strip->longestCorridor > analytics.longestCorridor)
+            analytics.longestCorridor = strip->longestCorridor;
+        for (int bucket = 0; bucket < corridorHistogramSize; bucket++)
+            analytics.corridorHistogram[bucket] += strip->corridorHistogram[bucket];
+    }
+    analytics.solutionMoves = solutionMoves;
+    analytics.seconds = elapsedSeconds(start);
+
+    free(strips);
+    free(threads);
+    return analytics;
+}
+
+void printJSONString(FILE *output, const char *text) {
+    /*
+    Subroutine that prints a text as a JSON string, with its quotes, escaping quotes, backslashes (Windows
+    paths) and control characters.
+    */
+    fputc('"', output);
+    for (const unsigned char *character = (const unsigned char *) text; *character != '\0'; character++) {
+        if (*character == '"' || *character == '\\')
+            fprintf(output, "\\%c", *character);
+        else if (*character < 0x20)
+            fprintf(output, "\\u%04x", *character);
+        else
+            fputc(*character, output);
+    }
+    fputc('"', output);
+}
+
+void printAnalyticsJSON(FILE *output, const char *name, const PackedLaberynth *packed, const LaberynthAnalytics *analytics) {
+    /*
+    Subroutine that prints the metrics of a laberynth as one JSON record on a single line.
+    */
+    fprintf(output, "{\"name\":");
+    printJSONString(output, name);
+    fprintf(output, ",\"rows\":%d,\"columns\":%d,\"cells\":%lld,\"deadEnds\":%lld,\"corridorCells\":%lld,"
+            "\"junctions\":%lld,\"corridors\":%lld,\"averageCorridor\":%.3f,\"longestCorridor\":%lld,\"corridorHistogram\":[",
+            packed->rows, packed->columns, analytics->cells, analytics->deadEnds, analytics->corridorCells,
+            analytics->junctions, analytics->corridors,
+            analytics->corridors > 0 ? (double) analytics->corridorCells / analytics->corridors : 0.0, analytics->longestCorridor);
+    int lastBucket = corridorHistogramSize - 1;
+    while (lastBucket > 0 && analytics->corridorHistogram[lastBucket] == 0)
+        lastBucket--;
+    for (int bucket = 0; bucket <= lastBucket; bucket++)
+        fprintf(output, "%s%lld", bucket > 0 ? "," : "", analytics->corridorHistogram[bucket]);
+    long long solutionCells = analytics->solutionMoves >= 0 ? analytics->solutionMoves + 1 : 0;
+    fprintf(output, "],\"solutionLength\":%lld,\"solutionShare\":%.6f,\"seconds\":%.6f}\n", analytics->solutionMoves,
+            (double) solutionCells / analytics->cells, analytics->seconds);
+}
+
+/*******************************Laberynth Validator*******************************/
+/*
+A laberynth is valid (perfect) when:
+// Symmetry ; The two cells of every border agree, as removeBarrierCell leaves them
+// Borders ; Nothing opens to the outside except the entrance above (0, 0) and the exit below the last cell,
+//           both added by stepFive
+// Tree ; Every cell is reachable and there are no loops, so there is exactly one path between two cells
+Symmetry and borders are checked comparing whole rows four cells at a time with GCC vector types, which are
+SIMD registers (SSE2, NEON) at any optimization level instead of waiting for -O3 to vectorize a loop. The tree
+is checked with a union find over the openings: each thread joins the cells of its strip of rows (the strips
+use different parts of the parent array, so no locks are needed), then the openings between strips are joined.
+An opening that joins two cells that were already connected closes a loop. Cell numbers are size_t, so grids of
+more than 2^31 cells work.
+*/
+
+typedef int rowVector __attribute__((vector_size(16)));
+#define rowVectorLanes 4
+
+typedef struct {
+    int **matrix;                 // One of the two sources is used
+    const PackedLaberynth *packed;
+    int rows;
+    int columns;
+    const AllocationOptions *options; // Allocation of the union-find parents, NULL for malloc
+} ValidatorSource;
+
+typedef struct {
+    long long asymmetricBorders;
+    long long outerOpenings;      // Openings to the outside other than the entrance and the exit
+    bool entranceOpen;
+    bool exitOpen;
+    long long components;
+    long long loops;
+    bool valid;
+    bool outOfMemory;             // Not validated, there was no memory for the parents
+    double seconds;
+} LaberynthValidation;
+
+typedef struct {
+    const ValidatorSource *source;
+    size_t *parent;
+    int firstRow;
+    int lastRow;
+    int node;                     // NUMA node of the strip in a matrix touched with as many threads, -1 not pinned
+    long long asymmetricBorders;
+    long long outerOpenings;
+    long long joins;
+    long long loops;
+} ValidatorStrip;
+
+const int *validatorRow(const ValidatorSource *source, int x, int *buffer) {
+    /*
+    Subroutine that gives the values of a row: the row of the matrix itself, or the row unpacked in buffer.
+    */
+    if (source->matrix != NULL)
+        return source->matrix[x];
+    for (int y = 0; y < source->columns; y++)
+        buffer[y] = packedCellValue(source->packed, x, y);
+    return buffer;
+}
+
+size_t findRoot(size_t *parent, size_t cell) {
+    while (parent[cell] != cell) {
+        parent[cell] = parent[parent[cell]]; // Path halving
+        cell = parent[cell];
+    }
+    return cell;
+}
+
+bool joinCells(size_t *parent, size_t first, size_t second) {
+    /*
+    Subroutine that joins the sets of two cells.
+    Outputs:
+        -false if they were already in the same set, so the opening between them closes a loop.
+    */
+    first = findRoot(parent, first);
+    second = findRoot(parent, second);
+    if (first == second)
+        return false;
+    if (first < second)
+        parent[second] = first;
+    else
+        parent[first] = second;
+    return true;
+}
+
+long long rowAsymmetricBorders(const int *row, const int *nextRow, int columns) {
+    /*
+    Subroutine that counts the borders of a row whose two sides disagree: right against the left of the next
+    cell, and below against the above of the cell in nextRow (NULL for the last row).
+    */
+    rowVector counts = {0, 0, 0, 0};
+    rowVector current, next;
+    int y = 0;
+    for (; y + rowVectorLanes < columns; y += rowVectorLanes) { // The cells on the right are one further
+        memcpy(&current, row + y, sizeof(rowVector));
+        memcpy(&next, row + y + 1, sizeof(rowVector));
+        counts += (current & rightOpening) ^ ((next & leftOpening) >> 2);
+    }
+    long long asymmetric = 0;
+    for (; y + 1 < columns; y++)
+        asymmetric += (row[y] & rightOpening) ^ ((row[y + 1] & leftOpening) >> 2);
+    if (nextRow != NULL) {
+        for (y = 0; y + rowVectorLanes <= columns; y += rowVectorLanes) {
+            memcpy(&current, row + y, sizeof(rowVector));
+            memcpy(&next, nextRow + y, sizeof(rowVector));
+            counts += ((current & belowOpening) >> 1) ^ ((next & aboveOpening) >> 3);
+        }
+        for (; y < columns; y++)
+            asymmetric += ((row[y] & belowOpening) >> 1) ^ ((nextRow[y] & aboveOpening) >> 3);
+    }
+    for (int lane = 0; lane < rowVectorLanes; lane++)
+        asymmetric += counts[lane];
+    return asymmetric;
+}
+
+void *validatorStripThread(void *argument) {
+    /*
+    Subroutine that checks the borders of a strip of rows and joins the cells connected inside it.
+    */
+    ValidatorStrip *strip = argument;
+    const ValidatorSource *source = strip->source;
+    if (strip->node >= 0)
+        pinThreadToNode(strip->node);
+    int rows = source->rows;
+    int columns = source->columns;
+    int *buffer = malloc(sizeof(int) * columns);
+    int *nextBuffer = malloc(sizeof(int) * columns);
+
+    const int *row = validatorRow(source, strip->firstRow, buffer);
+    for (int x = strip->firstRow; x < strip->lastRow; x++) {
+        const int *nextRow = x + 1 < rows ? validatorRow(source, x + 1, nextBuffer) : NULL;
+        strip->asymmetricBorders += rowAsymmetricBorders(row, nextRow, columns);
+
+        // Outer borders, the entrance and the exit are checked apart
+        strip->outerOpenings += (row[0] & leftOpening) != 0;
+        strip->outerOpenings += (row[columns - 1] & rightOpening) != 0;
+        if (x == 0) {
+            for (int y = 1; y < columns; y++)
+                strip->outerOpenings += (row[y] & aboveOpening) != 0;
+        }
+        if (x == rows - 1) {
+            for (int y = 0; y + 1 < columns; y++)
+                strip->outerOpenings += (row[y] & belowOpening) != 0;
+        }
+
+        // Openings inside the strip, the ones below its last row are joined later
+        size_t cell = (size_t) x * columns;
+        for (int y = 0; y + 1 < columns; y++) {
+            if (row[y] & rightOpening) {
+                if (joinCells(strip->parent, cell + y, cell + y + 1)) strip->joins++; else strip->loops++;
+            }
+        }
+        if (x + 1 < strip->lastRow) {
+            for (int y = 0; y < columns; y++) {
+                if (row[y] & belowOpening) {
+                    if (joinCells(strip->parent, cell + y, cell + columns + y)) strip->joins++; else strip->loops++;
+                }
+            }
+        }
+
+        // The next row becomes the current one
+        if (nextRow != NULL) {
+            if (source->matrix == NULL) {
+                int *swap = buffer; buffer = nextBuffer; nextBuffer = swap;
+            }
+            row = nextRow;
+        }
+    }
+    free(buffer);
+    free(nextBuffer);
+    return NULL;
+}
+
+LaberynthValidation validateSource(const ValidatorSource *source, int threadCount) {
+    /*
+    Subroutine that validates a laberynth given as a matrix or as a packed laberynth.
+    */
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int rows = source->rows;
+    int columns = source->columns;
+    size_t totalCells = (size_t) rows * columns;
+    if (threadCount <= 0)
+        threadCount = threadsAvailable();
+    if (threadCount > rows)
+        threadCount = rows;
+    // A matrix touched by as many threads is split in the same strips, each one checked in the node of its memory
+    bool pinned = source->matrix != NULL && rows > 0 && largeBlockTouchThreads(source->matrix[0]) == threadCount && numaNodes() > 1;
+    int stripRows = matrixStripRows(rows, threadCount);
+    if (pinned)
+        threadCount = (rows + stripRows - 1) / stripRows;
+
+    LaberynthValidation validation;
+    memset(&validation, 0, sizeof(validation));
+    size_t stripBytes = 0;
+    if (source->options != NULL && source->options->touchThreads > 0)
+        stripBytes = sizeof(size_t) * (size_t) columns * matrixStripRows(rows, source->options->touchThreads);
+    size_t *parent = allocateLargeBlock(sizeof(size_t) * totalCells, stripBytes, source->options);
+    if (parent == NULL) {
+        validation.outOfMemory = true;
+        return validation;
+    }
+    for (size_t cell = 0; cell < totalCells; cell++)
+        parent[cell] = cell;
+
+    ValidatorStrip *strips = calloc(threadCount, sizeof(ValidatorStrip));
+    pthread_t *threads = malloc(sizeof(pthread_t) * threadCount);
+    bool *started = calloc(threadCount, sizeof(bool));
+    // The calling thread is pinned for its strip and gets its processors back afterwards
+    cpu_set_t callerCpus;
+    bool restoreCpus = pinned && pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &callerCpus) == 0;
+    for (int thread = 0; thread < threadCount; thread++) {
+        strips[thread].source = source;
+        strips[thread].parent = parent;
+        if (pinned) {
+            strips[thread].firstRow = thread * stripRows;
+            strips[thread].lastRow = strips[thread].firstRow + stripRows < rows ? strips[thread].firstRow + stripRows : rows;
+            strips[thread].node = allocationNodeOfStrip(thread);
+        } else {
+            strips[thread].firstRow = (int) ((long long) rows * thread / threadCount);
+            strips[thread].lastRow = (int) ((long long) rows * (thread + 1) / threadCount);
+            strips[thread].node = -1;
+        }
+        if (thread > 0)
+            started[thread] = pthread_create(&threads[thread], NULL, validatorStripThread, &strips[thread]) == 0;
+    }
+    validatorStripThread(&strips[0]);
+    for (int thread = 1; thread < threadCount; thread++) {
+        if (!started[thread]) // Checked by the calling thread
+            validatorStripThread(&strips[thread]);
+    }
+    if (restoreCpus)
+        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &callerCpus);
+
+    long long joins = 0;
+    for (int thread = 0; thread < threadCount; thread++) {
+        if (started[thread])
+            pthread_join(threads[thread], NULL);
+        validation.asymmetricBorders += strips[thread].asymmetricBorders;
+        validation.outerOpenings += strips[thread].outerOpenings;
+        validation.loops += strips[thread].loops;
+        joins += strips[thread].joins;
+    }
+
+    // Openings between the strips
+    int *buffer = malloc(sizeof(int) * columns);
+    for (int thread = 1; thread < threadCount; thread++) {
+        int x = strips[thread].firstRow - 1;
+        const int *row = validatorRow(source, x, buffer);
+        for (int y = 0; y < columns; y++) {
+            if (row[y] & belowOpening) {
+                if (joinCells(parent, (size_t) x * columns + y, (size_t) (x + 1) * columns + y)) joins++; else validation.loops++;
+            }
+        }
+    }
+
+    const int *firstRow = validatorRow(source, 0, buffer);
+    validation.entranceOpen = firstRow[0] & aboveOpening;
+    const int *lastRow = validatorRow(source, rows - 1, buffer);
+    validation.exitOpen = lastRow[columns - 1] & belowOpening;
+    validation.components = (long long) totalCells - joins;
+    validation.valid = validation.asymmetricBorders == 0 && validation.outerOpenings == 0 && validation.entranceOpen
+        && validation.exitOpen && validation.components == 1 && validation.loops == 0;
+    validation.seconds = elapsedSeconds(start);
+
+    free(buffer);
+    releaseLargeBlock(parent);
+    free(strips);
+    free(threads);
+    free(started);
+    return validation;
+}
+
+LaberynthValidation validateLaberynthWithOptions(int **matrix, int rows, int columns, int threadCount, const AllocationOptions *options) {
+    /*
+    Subroutine that validates a laberynth stored in a matrix. Solver marks must be removed first.
+    Inputs and constraints:
+        -matrix, rows, columns: The laberynth.
+        -threadCount: Number of row strips checked in parallel, 0 uses one per processor. When the matrix was
+        touched by as many threads in createMatrixWithOptions the strips are those of the touch and every thread
+        runs in the NUMA node of its strip, otherwise the rows are split evenly and no thread is pinned.
+        -options: Allocation of the parents of the union-find (8 bytes per cell) as in createMatrixWithOptions,
+        NULL for malloc. The options of the matrix place every strip of parents with its rows.
+    Outputs:
+        -What was found, valid is true only for a perfect laberynth with its entrance and exit.
+    */
+    ValidatorSource source = {matrix, NULL, rows, columns, options};
+    return validateSource(&source, threadCount);
+}
+
+LaberynthValidation validateLaberynth(int **matrix, int rows, int columns, int threadCount) {
+    return validateLaberynthWithOptions(matrix, rows, columns, threadCount, NULL);
+}
+
+LaberynthValidation validatePackedLaberynth(const PackedLaberynth *packed, int threadCount) {
+    /*
+    Subroutine that validates a packed or mapped laberynth, the rows are unpacked one at a time by each thread.
+    In half wall packing the two sides of a border are the same bit, so symmetry always holds.
+    */
+    ValidatorSource source = {NULL, packed, packed->rows, packed->columns, NULL};
+    return validateSource(&source, threadCount);
+}
+
+void printValidation(FILE *output, const char *name, const LaberynthValidation *validation) {
+    if (validation->outOfMemory) {
+        fprintf(output, "%s: not validated, out of memory\n", name);
+        return;
+    }
+    fprintf(output, "%s: %s (asymmetric borders %lld, outer openings %lld, entrance %s, exit %s, components %lld, loops %lld, %.3f s)\n",
+            name, validation->valid ? "valid" : "INVALID", validation->asymmetricBorders, validation->outerOpenings,
+            validation->entranceOpen ? "open" : "closed", validation->exitOpen ? "open" : "closed",
+            validation->components, validation->loops, validation->seconds);
+}
+
+/*******************************Compressed Laberynths*******************************/
+/*
+In a perfect laberynth the left opening of a cell is the right opening of the cell on its left and the above
+opening is the below opening of the cell above it, so only the right and below openings carry information, the
+2 bits per cell of halfWallPacking. The compressed format goes under that because those 2 bits are far from
+free: a right opening that would close a loop never appears, and a below opening is forced when the cell would
+otherwise seal its part of the laberynth away from the rest.
+Every cell is coded as 4 binary decisions (left, above, right, below) with an adaptive binary range coder, each
+decision with its own probability for every context of already known bits. Besides the neighbor openings, the
+contexts hold what BlockComponents knows of the connected parts of the two last rows (union find over them):
+    -loop: The cell and the upper right cell are already connected and the upper right cell opens below, so a
+    right opening would close a loop.
+    -sealed: Nothing connects the part of the cell with the rows below except this cell (below context) or, on
+    the last row, the cells on its right (right context).
+The contexts are computed in the same way from the decoded bits, so the coding stays lossless for any nibbles,
+they only cost more when they do not follow a perfect laberynth.
+The rows are split in blocks that reset the probabilities and never look at the rows of another block (the
+first row of a block is connected to the rows before it through its above openings), so every block can be
+decoded alone: in parallel, or on demand by a solver through a small cache of decoded blocks.
+File:
+// CompressedLaberynthHeader ; magic "LABZ", version, size, rows per block and number of blocks
+// blockOffset ; blockCount + 1 offsets from the start of the first block
+// blocks ; range coded blocks, one after the other
+*/
+
+#define compressedVersion 2
+#define probabilityBits 15
+#define probabilityOne (1 << probabilityBits)
+#define probabilityMoveBits 6
+#define rangeTopValue (1u << 24)
+
+typedef struct {
+    char magic[4];
+    unsigned int version;
+    unsigned int rows;
+    unsigned int columns;
+    unsigned int rowsPerBlock;
+    unsigned int blockCount;
+} CompressedLaberynthHeader;
+
+typedef struct {
+    unsigned short left[3];    // Context: right opening of the left cell, 2 on the first column
+    unsigned short above[3];   // Context: below opening of the upper cell, 2 on the first row of the block
+    unsigned short right[64];  // Context: left, above, last column, loop, sealed, right of the upper cell
+    unsigned short below[256]; // Context: left, above, right, last row, sealed, below of the left cell,
+                               // right of the upper cell, exit cell
+} CellModel;
+
+typedef struct {
+    unsigned long long low;
+    unsigned int range;
+    unsigned char cache;
+    unsigned long long cacheSize;
+    unsigned char *output;
+    size_t size;
+    size_t capacity;
+} RangeEncoder;
+
+typedef struct {
+    unsigned int code;
+    unsigned int range;
+    const unsigned char *input;
+    const unsigned char *end;
+} RangeDecoder;
+
+void initializeCellModel(CellModel *model) {
+    unsigned short *probabilities = (unsigned short *) model;
+    for (size_t i = 0; i < sizeof(CellModel) / sizeof(unsigned short); i++)
+        probabilities[i] = probabilityOne / 2;
+}
+
+void putEncodedByte(RangeEncoder *encoder, unsigned char byte) {
+    if (encoder->size == encoder->capacity) {
+        encoder->capacity = encoder->capacity > 0 ? encoder->capacity * 2 : 4096;
+        encoder->output = realloc(encoder->output, encoder->capacity);
+    }
+    encoder->output[encoder->size++] = byte;
+}
+
+void shiftEncoderLow(RangeEncoder *encoder) {
+    /*
+    Subroutine that moves the top byte of low to the output, holding back 0xFF bytes until the carry is known.
+    References:
+        -Pavlov, I. (2013). LZMA SDK, LzmaEnc.c (RangeEnc_ShiftLow). https://www.7-zip.org/sdk.html
+    */
+    if ((unsigned int) encoder->low < 0xFF000000u || (encoder->low >> 32) != 0) {
+        unsigned char carry = (unsigned char) (encoder->low >> 32);
+        unsigned char byte = encoder->cache;
+        do {
+            putEncodedByte(encoder, byte + carry);
+            byte = 0xFF;
+        } while (--encoder->cacheSize != 0);
+        encoder->cache = (unsigned char) (encoder->low >> 24);
+    }
+    encoder->cacheSize++;
+    encoder->low = (encoder->low & 0x00FFFFFFu) << 8;
+}
+
+void encodeBit(RangeEncoder *encoder, unsigned short *probability, int bit) {
+    /*
+    Subroutine that codes one bit with the probability of its context and adapts the probability.
+    */
+    unsigned int bound = (encoder->range >> probabilityBits) * *probability;
+    if (bit == 0) {
+        encoder->range = bound;
+        *probability += (probabilityOne - *probability) >> probabilityMoveBits;
+    } else {
+        encoder->low += bound;
+        encoder->range -= bound;
+        *probability -= *probability >> probabilityMoveBits;
+    }
+    while (encoder->range < rangeTopValue) {
+        encoder->range <<= 8;
+        shiftEncoderLow(encoder);
+    }
+}
+
+int decodeBit(RangeDecoder *decoder, unsigned short *probability) {
+    unsigned int bound = (decoder->range >> probabilityBits) * *probability;
+    int bit;
+    if (decoder->code < bound) {
+        decoder->range = bound;
+        *probability += (probabilityOne - *probability) >> probabilityMoveBits;
+        bit = 0;
+    } else {
+        decoder->code -= bound;
+        decoder->range -= bound;
+        *probability -= *probability >> probabilityMoveBits;
+        bit = 1;
+    }
+    while (decoder->range < rangeTopValue) {
+        decoder->range <<= 8;
+        decoder->code = (decoder->code << 8) | (decoder->input < decoder->end ? *decoder->input++ : 0);
+    }
+    return bit;
+}
+
+typedef struct {
+    int columns;
+    int outside;               // Rows before the block, 2 * columns
+    int *parent;               // Upper row 0 .. columns - 1, current row columns .. 2 * columns - 1, outside
+    int *pending;              // Of a root: upper cells right of the current one that open below
+    int *label;                // Of a root while the current row becomes the upper row, -1 otherwise
+    int *rowRoot;
+} BlockComponents;
+
+void initializeBlockComponents(BlockComponents *components, int columns) {
+    components->columns = columns;
+    components->outside = 2 * columns;
+    components->parent = malloc(sizeof(int) * (2 * columns + 1));
+    components->pending = calloc(2 * columns + 1, sizeof(int));
+    components->label = malloc(sizeof(int) * (2 * columns + 1));
+    components->rowRoot = malloc(sizeof(int) * columns);
+    for (int id = 0; id <= components->outside; id++) {
+        components->parent[id] = id;
+        components->label[id] = -1;
+    }
+}
+
+void freeBlockComponents(BlockComponents *components) {
+    free(components->parent);
+    free(components->pending);
+    free(components->label);
+    free(components->rowRoot);
+}
+
+static inline int findComponent(BlockComponents *components, int id) {
+    while (components->parent[id] != id) {
+        components->parent[id] = components->parent[components->parent[id]];
+        id = components->parent[id];
+    }
+    return id;
+}
+
+static inline void joinComponents(BlockComponents *components, int first, int second) {
+    first = findComponent(components, first);
+    second = findComponent(components, second);
+    if (first == second)
+        return;
+    if (second == components->outside || (first != components->outside && second < first)) { // The outside stays a root
+        int swap = first; first = second; second = swap;
+    }
+    components->parent[second] = first;
+    components->pending[first] += components->pending[second];
+}
+
+static inline bool sealedComponent(BlockComponents *components, int root) {
+    return root != components->outside && components->pending[root] == 0;
+}
+
+void startComponentRow(BlockComponents *components, const int *upperRow) {
+    /*
+    Subroutine that prepares the current row, upperRow is NULL on the first row of a block.
+    */
+    int columns = components->columns;
+    for (int y = 0; y < columns; y++) {
+        components->parent[columns + y] = columns + y;
+        components->pending[columns + y] = 0;
+    }
+    if (upperRow == NULL)
+        return;
+    for (int y = 0; y < columns; y++)
+        components->pending[y] = 0;
+    for (int y = 0; y < columns; y++) {
+        if (upperRow[y] & belowOpening)
+            components->pending[findComponent(components, y)]++;
+    }
+}
+
+void endComponentRow(BlockComponents *components) {
+    /*
+    Subroutine that turns the components of the current row into the components of the upper row.
+    */
+    int columns = components->columns;
+    for (int y = 0; y < columns; y++)
+        components->rowRoot[y] = findComponent(components, columns + y);
+    for (int y = 0; y < columns; y++) {
+        int root = components->rowRoot[y];
+        if (root == components->outside) {
+            components->parent[y] = root;
+        } else if (components->label[root] < 0) {
+            components->label[root] = y;
+            components->parent[y] = y;
+        } else {
+            components->parent[y] = components->label[root];
+        }
+    }
+    for (int y = 0; y < columns; y++)
+        components->label[components->rowRoot[y]] = -1;
+}
+
+static inline void cellContexts(const int *row, const int *upperRow, int y, int *leftContext, int *aboveContext) {
+    /*
+    Subroutine that computes the contexts of the left and above bits of a cell from the cells already coded
+    (upperRow is NULL on the first row of a block).
+    */
+    *leftContext = y > 0 ? row[y - 1] & rightOpening : 2;
+    *aboveContext = upperRow != NULL ? (upperRow[y] & belowOpening) >> 1 : 2;
+}
+
+static inline int rightContext(BlockComponents *components, const int *upperRow, int y, int value, bool lastRow) {
+    /*
+    Subroutine that joins the cell to its upper cell if it opens above and gives the context of the right bit.
+    Inputs and constraints:
+        -value: Left and above bits of the cell.
+    */
+    int columns = components->columns;
+    int cell = columns + y;
+    bool lastColumn = y == columns - 1;
+    if (upperRow != NULL && (upperRow[y] & belowOpening) && findComponent(components, y) != components->outside)
+        components->pending[findComponent(components, y)]--;
+    if (value & aboveOpening)
+        joinComponents(components, cell, upperRow != NULL ? y : components->outside);
+    int root = findComponent(components, cell);
+    bool loop = !lastColumn && upperRow != NULL && (upperRow[y + 1] & belowOpening) && findComponent(components, y + 1) == root;
+    bool sealed = lastRow && !lastColumn && sealedComponent(components, root);
+    int upperRight = upperRow != NULL ? upperRow[y] & rightOpening : 0;
+    return ((value & leftOpening) != 0) | (((value & aboveOpening) != 0) << 1) | (lastColumn << 2) | (loop << 3) | (sealed << 4)
+        | (upperRight << 5);
+}
+
+static inline int belowContext(BlockComponents *components, const int *row, const int *upperRow, int y, int value, bool lastRow) {
+    /*
+    Subroutine that joins the cell to the cell on its right if it opens right and gives the context of the below bit.
+    Inputs and constraints:
+        -value: Left, above and right bits of the cell.
+    */
+    int columns = components->columns;
+    int cell = columns + y;
+    bool lastColumn = y == columns - 1;
+    if ((value & rightOpening) && !lastColumn)
+        joinComponents(components, cell, cell + 1);
+    bool sealed = !lastRow && !((value & rightOpening) && !lastColumn) && sealedComponent(components, findComponent(components, cell));
+    bool leftBelow = y > 0 && (row[y - 1] & belowOpening);
+    int upperRight = upperRow != NULL ? upperRow[y] & rightOpening : 0;
+    return ((value & leftOpening) != 0) | (((value & aboveOpening) != 0) << 1) | ((value & rightOpening) << 2) | (lastRow << 3)
+        | (sealed << 4) | (leftBelow << 5) | (upperRight << 6) | ((lastRow && lastColumn) << 7);
+}
+
+void encodeLaberynthBlock(int **matrix, int firstRow, int lastRow, int rows, int columns, RangeEncoder *encoder) {
+    /*
+    Subroutine that codes the rows firstRow .. lastRow - 1 as an independent block.
+    */
+    CellModel model;
+    initializeCellModel(&model);
+    memset(encoder, 0, sizeof(RangeEncoder));
+    encoder->range = 0xFFFFFFFFu;
+    encoder->cacheSize = 1;
+
+    BlockComponents components;
+    initializeBlockComponents(&components, columns);
+    int *row = malloc(sizeof(int) * columns);
+    int *upperRow = malloc(sizeof(int) * columns);
+    for (int x = firstRow; x < lastRow; x++) {
+        const int *upper = x > firstRow ? upperRow : NULL;
+        startComponentRow(&components, upper);
+        for (int y = 0; y < columns; y++) {
+            int value = matrix[x][y] % 16;
+            int leftContext, aboveContext;
+            cellContexts(row, upper, y, &leftContext, &aboveContext);
+            encodeBit(encoder, &model.left[leftContext], (value & leftOpening) != 0);
+            encodeBit(encoder, &model.above[aboveContext], (value & aboveOpening) != 0);
+            encodeBit(encoder, &model.right[rightContext(&components, upper, y, value & (leftOpening | aboveOpening), x == rows - 1)],
+                      value & rightOpening);
+            encodeBit(encoder, &model.below[belowContext(&components, row, upper, y, value & ~belowOpening, x == rows - 1)],
+                      (value & belowOpening) != 0);
+            row[y] = value;
+        }
+        endComponentRow(&components);
+        int *swap = upperRow; upperRow = row; row = swap;
+    }
+    for (int i = 0; i < 5; i++)
+        shiftEncoderLow(encoder);
+    free(row);
+    free(upperRow);
+    freeBlockComponents(&components);
+}
+
+void decodeLaberynthBlock(const unsigned char *input, size_t inputSize, int firstRow, int lastRow, int rows, int columns, int *cells) {
+    /*
+    Subroutine that decodes an independent block into cells, (lastRow - firstRow) * columns values row by row.
+    */
+    CellModel model;
+    initializeCellModel(&model);
+    RangeDecoder decoder = {0, 0xFFFFFFFFu, input, input + inputSize};
+    for (int i = 0; i < 5; i++)
+        decoder.code = (decoder.code << 8) | (decoder.input < decoder.end ? *decoder.input++ : 0);
+
+    BlockComponents components;
+    initializeBlockComponents(&components, columns);
+    for (int x = firstRow; x < lastRow; x++) {
+        int *row = cells + (size_t) (x - firstRow) * columns;
+        const int *upperRow = x > firstRow ? row - columns : NULL;
+        startComponentRow(&components, upperRow);
+        for (int y = 0; y < columns; y++) {
+            int leftContext, aboveContext;
+            cellContexts(row, upperRow, y, &leftContext, &aboveContext);
+            int value = decodeBit(&decoder, &model.left[leftContext]) ? leftOpening : 0;
+            value |= decodeBit(&decoder, &model.above[aboveContext]) ? aboveOpening : 0;
+            value |= decodeBit(&decoder, &model.right[rightContext(&components, upperRow, y, value, x == rows - 1)]) ? rightOpening : 0;
+            value |= decodeBit(&decoder, &model.below[belowContext(&components, row, upperRow, y, value, x == rows - 1)]) ? belowOpening : 0;
+            row[y] = value;
+        }
+        endComponentRow(&components);
+    }
+    freeBlockComponents(&components);
+}
+
+typedef struct {
+    int **matrix;
+    int rows;
+    int columns;
+    int rowsPerBlock;
+    int blockCount;
+    int nextBlock;             // Taken with an atomic add by the threads
+    RangeEncoder *encoders;
+} CompressionJob;
+
+void *compressionThread(void *argument) {
+    CompressionJob *job = argument;
+    while (true) {
+        int block = __atomic_fetch_add(&job->nextBlock, 1, __ATOMIC_RELAXED);
+        if (block >= job->blockCount)
+            break;
+        int firstRow = block * job->rowsPerBlock;
+        int lastRow = firstRow + job->rowsPerBlock < job->rows ? firstRow + job->rowsPerBlock : job->rows;
+        encodeLaberynthBlock(job->matrix, firstRow, lastRow, job->rows, job->columns, &job->encoders[block]);
+    }
+    return NULL;
+}
+
+long long compressLaberynth(const char *path, int **matrix, int rows, int columns, int rowsPerBlock, int threadCount) {
+    /*
+    Subroutine that writes a laberynth in the compressed format, coding its blocks in parallel.
+    Inputs and constraints:
+        -path: File to create.
+        -matrix, rows, columns: The laberynth, solver marks are dropped.
+        -rowsPerBlock: Rows of each independent block, smaller blocks decode with more parallelism but compress less.
+        -threadCount: Threads that code blocks, 0 uses one per processor.
+    Outputs:
+        -Size of the file in bytes, or -1 if it could not be written.
+    */
+    if (threadCount <= 0)
+        threadCount = threadsAvailable();
+    CompressionJob job;
+    job.matrix = matrix;
+    job.rows = rows;
+    job.columns = columns;
+    job.rowsPerBlock = rowsPerBlock;
+    job.blockCount = (rows + rowsPerBlock - 1) / rowsPerBlock;
+    job.nextBlock = 0;
+    job.encoders = calloc(job.blockCount, sizeof(RangeEncoder));
+
+    pthread_t *threads = malloc(sizeof(pthread_t) * threadCount);
+    for (int thread = 1; thread < threadCount; thread++)
+        pthread_create(&threads[thread], NULL, compressionThread, &job);
+    compressionThread(&job);
+    for (int thread = 1; thread < threadCount; thread++)
+        pthread_join(threads[thread], NULL);
+    free(threads);
+
+    CompressedLaberynthHeader header;
+    memcpy(header.magic, "LABZ", 4);
+    header.version = compressedVersion;
+    header.rows = rows;
+    header.columns = columns;
+    header.rowsPerBlock = rowsPerBlock;
+    header.blockCount = job.blockCount;
+    unsigned long long *blockOffset = malloc(sizeof(unsigned long long) * (job.blockCount + 1));
+    blockOffset[0] = 0;
+    for (int block = 0; block < job.blockCount; block++)
+        blockOffset[block + 1] = blockOffset[block] + job.encoders[block].size;
+
+    long long fileBytes = -1;
+    FILE *file = fopen(path, "wb");
+    if (file != NULL) {
+        bool written = fwrite(&header, sizeof(header), 1, file) == 1
+            && fwrite(blockOffset, sizeof(unsigned long long), job.blockCount + 1, file) == (size_t) job.blockCount + 1;
+        for (int block = 0; block < job.blockCount && written; block++)
+            written = fwrite(job.encoders[block].output, 1, job.encoders[block].size, file) == job.encoders[block].size;
+        if (fclose(file) == 0 && written)
+            fileBytes = sizeof(header) + sizeof(unsigned long long) * (job.blockCount + 1) + blockOffset[job.blockCount];
+    }
+
+    for (int block = 0; block < job.blockCount; block++)
+        free(job.encoders[block].output);
+    free(job.encoders);
+    free(blockOffset);
+    return fileBytes;
+}
+
+typedef struct {
+    int rows;
+    int columns;
+    int rowsPerBlock;
+    int blockCount;
+    const unsigned long long *blockOffset;
+    const unsigned char *blocks;
+    void *mapping;
+    size_t mappingBytes;
+    int cachedBlocks;          // Decoded blocks kept for compressedCellValue
+    int *cachedBlock;          // Block held by every cache slot, -1 if empty
+    unsigned long long *cacheLastUse;
+    int **cacheCells;
+    unsigned long long clock;
+} CompressedLaberynth;
+
+CompressedLaberynth *openCompressedLaberynth(const char *path, int cachedBlocks) {
+    /*
+    Subroutine that maps a compressed laberynth, nothing is decoded yet.
+    Inputs and constraints:
+        -path: File written by compressLaberynth.
+        -cachedBlocks: Decoded blocks kept in memory by compressedCellValue.
+    Outputs:
+        -The compressed laberynth, or NULL if the file is not valid. It must be closed with closeCompressedLaberynth.
+    */
+    int file = open(path, O_RDONLY);
+    if (file < 0)
+        return NULL;
+    struct stat information;
+    if (fstat(file, &information) != 0 || (size_t) information.st_size < sizeof(CompressedLaberynthHeader)) {
+        close(file);
+        return NULL;
+    }
+    void *mapping = mmap(NULL, information.st_size, PROT_READ, MAP_SHARED, file, 0);
+    close(file);
+    if (mapping == MAP_FAILED)
+        return NULL;
+
+    const CompressedLaberynthHeader *header = mapping;
+    size_t fileBytes = information.st_size;
+    size_t tableEnd = sizeof(CompressedLaberynthHeader) + sizeof(unsigned long long) * ((size_t) header->blockCount + 1);
+    const unsigned long long *blockOffset = (const unsigned long long *) ((const char *) mapping + sizeof(CompressedLaberynthHeader));
+    bool valid = memcmp(header->magic, "LABZ", 4) == 0 && header->version == compressedVersion && header->rows > 0
+        && header->rows <= INT_MAX && header->columns > 0 && header->columns <= INT_MAX / 2 && header->rowsPerBlock > 0
+        && header->blockCount == (header->rows - 1) / header->rowsPerBlock + 1
+        && fileBytes >= tableEnd && blockOffset[header->blockCount] <= fileBytes - tableEnd;
+    // Every block must lie inside the file, the decoder trusts its start and length
+    for (unsigned int block = 0; valid && block < header->blockCount; block++)
+        valid = blockOffset[block] <= blockOffset[block + 1];
+    if (!valid) {
+        munmap(mapping, information.st_size);
+        return NULL;
+    }
+
+    CompressedLaberynth *compressed = malloc(sizeof(CompressedLaberynth));
+    compressed->rows = header->rows;
+    compressed->columns = header->columns;
+    compressed->rowsPerBlock = header->rowsPerBlock;
+    compressed->blockCount = header->blockCount;
+    compressed->blockOffset = blockOffset;
+    compressed->blocks = (const unsigned char *) mapping + tableEnd;
+    compressed->mapping = mapping;
+    compressed->mappingBytes = information.st_size;
+    compressed->cachedBlocks = cachedBlocks > 0 ? cachedBlocks : 1;
+    compressed->cachedBlock = malloc(sizeof(int) * compressed->cachedBlocks);
+    compressed->cacheLastUse = calloc(compressed->cachedBlocks, sizeof(unsigned long long));
+    compressed->cacheCells = calloc(compressed->cachedBlocks, sizeof(int *));
+    compressed->clock = 0;
+    for (int slot = 0; slot < compressed->cachedBlocks; slot++)
+        compressed->cachedBlock[slot] = -1;
+    return compressed;
+}
+
+void closeCompressedLaberynth(CompressedLaberynth *compressed) {
+    for (int slot = 0; slot < compressed->cachedBlocks; slot++)
+        free(compressed->cacheCells[slot]);
+    free(compressed->cachedBlock);
+    free(compressed->cacheLastUse);
+    free(compressed->cacheCells);
+    munmap(compressed->mapping, compressed->mappingBytes);
+    free(compressed);
+}
+
+void decodeCompressedBlock(const CompressedLaberynth *compressed, int block, int *cells) {
+    /*
+    Subroutine that decodes one block of a compressed laberynth.
+    Inputs and constraints:
+        -compressed: The compressed laberynth.
+        -block: Block to decode, it holds the rows block * rowsPerBlock onwards.
+        -cells: Array with room for rowsPerBlock * columns values.
+    Outputs:
+        -The rows of the block, one after the other.
+    */
+    int firstRow = block * compressed->rowsPerBlock;
+    int lastRow = firstRow + compressed->rowsPerBlock < compressed->rows ? firstRow + compressed->rowsPerBlock : compressed->rows;
+    decodeLaberynthBlock(compressed->blocks + compressed->blockOffset[block], compressed->blockOffset[block + 1] - compressed->blockOffset[block],
+                         firstRow, lastRow, compressed->rows, compressed->columns, cells);
+}
+
+int compressedCellValue(CompressedLaberynth *compressed, int x, int y) {
+    /*
+    Subroutine that reads a cell of a compressed laberynth, decoding its block if it is not in the cache, so a
+    solver can walk a laberynth much bigger than the memory it is allowed to use.
+    */
+    int block = x / compressed->rowsPerBlock;
+    int slot = 0;
+    for (int candidate = 0; candidate < compressed->cachedBlocks; candidate++) {
+        if (compressed->cachedBlock[candidate] == block) {
+            slot = candidate;
+            break;
+        }
+        if (compressed->cacheLastUse[candidate] < compressed->cacheLastUse[slot])
+            slot = candidate;
+    }
+    if (compressed->cachedBlock[slot] != block) { // Least recently used slot replaced
+        if (compressed->cacheCells[slot] == NULL)
+            compressed->cacheCells[slot] = malloc(sizeof(int) * compressed->rowsPerBlock * compressed->columns);
+        decodeCompressedBlock(compressed, block, compressed->cacheCells[slot]);
+        compressed->cachedBlock[slot] = block;
+    }
+    compressed->cacheLastUse[slot] = ++compressed->clock;
+    return compressed->cacheCells[slot][(size_t) (x - block * compressed->rowsPerBlock) * compressed->columns + y];
+}
+
+typedef struct {
+    const CompressedLaberynth *compressed;
+    int **matrix;
+    int nextBlock;
+} DecompressionJob;
+
+void *decompressionThread(void *argument) {
+    DecompressionJob *job = argument;
+    while (true) {
+        int block = __atomic_fetch_add(&job->nextBlock, 1, __ATOMIC_RELAXED);
+        if (block >= job->compressed->blockCount)
+            break;
+        decodeCompressedBlock(job->compressed, block, job->matrix[block * job->compressed->rowsPerBlock]);
+    }
+    return NULL;
+}
+
+int **decompressLaberynth(const CompressedLaberynth *compressed, int threadCount) {
+    /*
+    Subroutine that decodes every block of a compressed laberynth in parallel into a new matrix.
+    Inputs and constraints:
+        -compressed: The compressed laberynth.
+        -threadCount: Threads that decode blocks, 0 uses one per processor.
+    Outputs:
+        -Matrix of compressed->rows x compressed->columns, released with freeMatrix.
+    */
+    if (threadCount <= 0)
+        threadCount = threadsAvailable();
+    int **matrix = createMatrix(compressed->rows, compressed->columns);
+    DecompressionJob job = {compressed, matrix, 0};
+    pthread_t *threads = malloc(sizeof(pthread_t) * threadCount);
+    for (int thread = 1; thread < threadCount; thread++)
+        pthread_create(&threads[thread], NULL, decompressionThread, &job);
+    decompressionThread(&job);
+    for (int thread = 1; thread < threadCount; thread++)
+        pthread_join(threads[thread], NULL);
+    free(threads);
+    return matrix;
+}
+
+long long randomMouseCompressed(CompressedLaberynth *compressed, long long maxCycles, unsigned long long seed) {
+    /*
+    Subroutine that runs the random mouse from the entrance to the exit reading the cells through the block cache
+    of a compressed laberynth, without marks.
+    Outputs:
+        -The number of cycles needed to reach the exit, or -1 if maxCycles was not enough.
+    */
+    unsigned long long randomState = seedRandom(seed);
+    int currentPositionX = 0;
+    int currentPositionY = 0;
+    long long totalCycles = 0;
+    while (currentPositionX != compressed->rows - 1 || currentPositionY != compressed->columns - 1) {
+        if (totalCycles == maxCycles)
+            return -1;
+        int value = compressedCellValue(compressed, currentPositionX, currentPositionY);
+        int direction;
+        do {
+            direction = nextRandom(&randomState) % 4;
+        } while (!(value & directionOpening[direction]) || currentPositionX + directionRowStep[direction] < 0
+                 || currentPositionX + directionRowStep[direction] >= compressed->rows);
+        currentPositionX += directionRowStep[direction];
+        currentPositionY += directionColumnStep[direction];
+        totalCycles++;
+    }
+    return totalCycles;
+}
+
+void compressionDemo(int rows, int columns, int rowsPerBlock, const char *path) {
+    /*
+    Subroutine that compresses a laberynth, decompresses it in parallel, checks both are equal and compares the
+    sizes, then runs a small random mouse on the compressed file.
+    */
+    int **matrix = createMatrix(rows, columns);
+    CellLayout layout = createCellLayout(rowMajorLayout, rows, columns);
+    generateLaberynthCells(matrix[0], &layout, 1);
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    long long fileBytes = compressLaberynth(path, matrix, rows, columns, rowsPerBlock, 0);
+    double compressSeconds = elapsedSeconds(start);
+    CompressedLaberynth *compressed = fileBytes >= 0 ? openCompressedLaberynth(path, 4) : NULL;
+    if (compressed == NULL) {
+        printf("Could not write %s\n", path);
+        freeMatrix(matrix, rows);
+        return;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int **decompressed = decompressLaberynth(compressed, 0);
+    double decompressSeconds = elapsedSeconds(start);
+    size_t differentCells = 0;
+    for (size_t cell = 0; cell < (size_t) rows * columns; cell++) {
+        if (decompressed[0][cell] != matrix[0][cell])
+            differentCells++;
+    }
+
+    size_t nibbleBytes = ((size_t) rows * columns + 1) / 2;
+    PackedLaberynth *halfWalls = packLaberynth(matrix, rows, columns, halfWallPacking);
+    printf("Nibbles: %zu bytes, half walls: %zu bytes, compressed: %lld bytes\n", nibbleBytes, halfWalls->bytes, fileBytes);
+    printf("Compressed: %.3f bits per cell, %.1f%% of the nibbles, %.1f%% of the half walls\n", fileBytes * 8.0 / ((double) rows * columns),
+           100.0 * fileBytes / nibbleBytes, 100.0 * fileBytes / halfWalls->bytes);
+    freePackedLaberynth(halfWalls);
+    printf("Compress: %.3f s, decompress: %.3f s, different cells: %zu\n", compressSeconds, decompressSeconds, differentCells);
+    printf("Random mouse on the compressed file: %lld cycles\n", randomMouseCompressed(compressed, 10000000, 1));
+
+    closeCompressedLaberynth(compressed);
+    freeMatrix(decompressed, rows);
+    freeMatrix(matrix, rows);
+}
+
+/*******************************Resumable Solvers*******************************/
+/*
+randomMouse and tremaux run until the exit is reached. A SolverState holds everything one of those loops keeps
+in local variables (position, moves, its own random generator, the way back of Tremaux), so stepSolver can do
+a bounded number of moves and return, and the next call continues where the last one stopped. Many solves can
+be interleaved by one thread with a bounded latency per call, and another thread can stop one with
+cancelSolver or give it a deadline.
+The marks on the matrix are the same as randomMouse: + 16 on the cells of the path from the entrance, so when a
+solve ends the marked cells are its path. Tremaux keeps the direction back to the previous cell in a separate
+byte per cell, which lets it leave dead ends and remove their marks.
+*/
+
+#define randomMouseSolver 0
+#define tremauxSolver     1
+
+#define solverInProgress 0 // The budget ran out, call stepSolver again
+#define solverSolved     1 // The exit was reached
+#define solverCancelled  2 // cancelSolver was called
+#define solverTimedOut   3 // The deadline passed
+#define solverFailed     4 // Tremaux went back to the entrance, the exit can not be reached
+
+#define solverCheckInterval 1024 // Moves between checks of the cancel flag and the clock
+
+typedef struct {
+    int kind;
+    int **matrix;
+    int rows;
+    int columns;
+    int currentPositionX;
+    int currentPositionY;
+    long long totalCycles;
+    unsigned long long randomState;
+    unsigned char *back;       // Tremaux: 0 not visited, 1 + direction to the previous cell, 5 entrance
+    bool ownsMemory;           // The state allocated its own buffer
+    bool hasDeadline;
+    struct timespec deadline;  // CLOCK_MONOTONIC
+    int cancelled;             // Set by cancelSolver from any thread
+    int status;
+} SolverState;
+
+size_t solverStateBytes(int kind, int rows, int columns) {
+    /*
+    Subroutine that gives the size of the buffer of a solve: the state and, for Tremaux, its way back.
+    */
+    return alignedBytes(sizeof(SolverState)) + (kind == tremauxSolver ? (size_t) rows * columns : 0);
+}
+
+SolverState *createSolverStateWithBuffer(int kind, int **matrix, int rows, int columns, unsigned long long seed, void *buffer) {
+    /*
+    Subroutine that prepares a solve from the entrance to the exit, marking the entrance.
+    Inputs and constraints:
+        -kind: randomMouseSolver or tremauxSolver.
+        -matrix: Laberynth without marks, it is marked while the solve advances.
+        -rows, columns: Size of the laberynth.
+        -seed: Seed of the random mouse, the same seed always gives the same moves.
+        -buffer: solverStateBytes bytes owned by the caller (an arena) that hold the whole state, or NULL to
+        allocate them here.
+    Outputs:
+        -The state, released with freeSolverState, or NULL if there is no memory.
+    */
+    bool ownsMemory = buffer == NULL;
+    if (ownsMemory && (buffer = malloc(solverStateBytes(kind, rows, columns))) == NULL)
+        return NULL;
+    SolverState *state = memset(buffer, 0, sizeof(SolverState));
+    state->ownsMemory = ownsMemory;
+    state->kind = kind;
+    state->matrix = matrix;
+    state->rows = rows;
+    state->columns = columns;
+    state->randomState = seedRandom(seed);
+    state->status = solverInProgress;
+    if (kind == tremauxSolver) {
+        state->back = memset((unsigned char *) buffer + alignedBytes(sizeof(SolverState)), 0, (size_t) rows * columns);
+        state->back[0] = 5;
+    }
+    matrix[0][0] += 16;
+    if (rows == 1 && columns == 1)
+        state->status = solverSolved;
+    return state;
+}
+
+SolverState *createSolverState(int kind, int **matrix, int rows, int columns, unsigned long long seed) {
+    return createSolverStateWithBuffer(kind, matrix, rows, columns, seed, NULL);
+}
+
+void freeSolverState(SolverState *state) {
+    if (state->ownsMemory)
+        free(state); // The start of the buffer
+}
+
+void setSolverDeadline(SolverState *state, double seconds) {
+    /*
+    Subroutine that stops the solve with solverTimedOut once seconds have passed from now.
+    */
+    clock_gettime(CLOCK_MONOTONIC, &state->deadline);
+    long long nanoseconds = state->deadline.tv_nsec + (long long) ((seconds - (long long) seconds) * 1e9);
+    state->deadline.tv_sec += (long long) seconds + nanoseconds / 1000000000;
+    state->deadline.tv_nsec = nanoseconds % 1000000000;
+    state->hasDeadline = true;
+}
+
+void cancelSolver(SolverState *state) {
+    /*
+    Subroutine that asks a solve to stop, it can be called from another thread while stepSolver runs.
+    */
+    __atomic_store_n(&state->cancelled, 1, __ATOMIC_RELAXED);
+}
+
+bool solverMustStop(SolverState *state) {
+    if (__atomic_load_n(&state->cancelled, __ATOMIC_RELAXED)) {
+        state->status = solverCancelled;
+        return true;
+    }
+    if (state->hasDeadline) {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if (now.tv_sec > state->deadline.tv_sec || (now.tv_sec == state->deadline.tv_sec && now.tv_nsec >= state->deadline.tv_nsec)) {
+            state->status = solverTimedOut;
+            return true;
+        }
+    }
+    return false;
+}
+
+static inline bool randomMouseMove(SolverState *state) {
+    /*
+    Subroutine that does one move of the random mouse, the same move and marks as randomMouse.
+    */
+    int **matrix = state->matrix;
+    int value = matrix[state->currentPositionX][state->currentPositionY] % 16;
+    int direction;
+    do {
+        direction = nextRandom(&state->randomState) % 4;
+    } while (!(value & directionOpening[direction]) || state->currentPositionX + directionRowStep[direction] < 0
+             || state->currentPositionX + directionRowStep[direction] >= state->rows);
+
+    int newPositionX = state->currentPositionX + directionRowStep[direction];
+    int newPositionY = state->currentPositionY + directionColumnStep[direction];
+    if (matrix[newPositionX][newPositionY] > 15) {
+        matrix[state->currentPositionX][state->currentPositionY] -= 16;
+    } else {
+        matrix[newPositionX][newPositionY] += 16;
+    }
+    state->currentPositionX = newPositionX;
+    state->currentPositionY = newPositionY;
+    return true;
+}
+
+static inline bool tremauxMove(SolverState *state) {
+    /*
+    Subroutine that does one move of Tremaux's algorithm: into the first passage never walked, or back through the
+    passage the cell was entered from once every other one was walked, removing the mark of the dead end.
+    Outputs:
+        -false if there is no way back because the whole reachable laberynth was walked.
+    */
+    int **matrix = state->matrix;
+    int rows = state->rows;
+    int columns = state->columns;
+    int x = state->currentPositionX;
+    int y = state->currentPositionY;
+    int value = matrix[x][y] % 16;
+    for (int direction = 0; direction < 4; direction++) {
+        int newPositionX = x + directionRowStep[direction];
+        int newPositionY = y + directionColumnStep[direction];
+        if ((value & directionOpening[direction]) && newPositionX >= 0 && newPositionX < rows && newPositionY >= 0 && newPositionY < columns
+            && state->back[(size_t) newPositionX * columns + newPositionY] == 0) {
+            state->back[(size_t) newPositionX * columns + newPositionY] = 1 + directionOpposite[direction];
+            matrix[newPositionX][newPositionY] += 16;
+            state->currentPositionX = newPositionX;
+            state->currentPositionY = newPositionY;
+            return true;
+        }
+    }
+
+    int back = state->back[(size_t) x * columns + y] - 1;
+    if (back == 4) // Back at the entrance with every passage walked
+        return false;
+    matrix[x][y] -= 16;
+    state->currentPositionX += directionRowStep[back];
+    state->currentPositionY += directionColumnStep[back];
+    return true;
+}
+
+int stepSolver(SolverState *state, long long budget) {
+    /*
+    Subroutine that advances a solve by at most budget moves.
+    Inputs and constraints:
+        -state: The solve, a finished solve is left as it is.
+        -budget: Maximum number of moves of this call.
+    Outputs:
+        -solverInProgress if the budget ran out before the solve finished, or the final status.
+    */
+    if (state->status != solverInProgress || solverMustStop(state))
+        return state->status;
+    int exitX = state->rows - 1;
+    int exitY = state->columns - 1;
+    long long moves = 0;
+    while (moves < budget) {
+        long long chunk = budget - moves < solverCheckInterval ? budget - moves : solverCheckInterval;
+        for (long long move = 0; move < chunk; move++) {
+            bool moved = state->kind == tremauxSolver ? tremauxMove(state) : randomMouseMove(state);
+            if (!moved) {
+                state->status = solverFailed;
+                return state->status;
+            }
+            state->totalCycles++;
+            if (state->currentPositionX == exitX && state->currentPositionY == exitY) {
+                state->status = solverSolved;
+                return state->status;
+            }
+        }
+        moves += chunk;
+        if (solverMustStop(state))
+            return state->status;
+    }
+    return state->status;
+}
+
+void resumableSolversDemo(int rows, int columns, int solves, long long budget) {
+    /*
+    Subroutine that interleaves several solves on one thread, a slice of budget moves each in turn, and reports
+    the longest time a single stepSolver call took.
+    */
+    int ***matrices = malloc(sizeof(int **) * solves);
+    SolverState **states = malloc(sizeof(SolverState *) * solves);
+    for (int solve = 0; solve < solves; solve++) {
+        matrices[solve] = createMatrix(rows, columns);
+        CellLayout layout = createCellLayout(rowMajorLayout, rows, columns);
+        generateLaberynthCells(matrices[solve][0], &layout, solve + 1);
+        states[solve] = createSolverState(solve % 2 == 0 ? tremauxSolver : randomMouseSolver, matrices[solve], rows, columns, solve + 1);
+        setSolverDeadline(states[solve], 10.0);
+    }
+
+    int running = solves;
+    long long calls = 0;
+    double longestCall = 0;
+    while (running > 0) {
+        running = 0;
+        for (int solve = 0; solve < solves; solve++) {
+            if (states[solve]->status != solverInProgress)
+                continue;
+            struct timespec start;
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            running += stepSolver(states[solve], budget) == solverInProgress;
+            double seconds = elapsedSeconds(start);
+            longestCall = seconds > longestCall ? seconds : longestCall;
+            calls++;
+        }
+    }
+
+    const char *statusNames[] = {"in progress", "solved", "cancelled", "timed out", "failed"};
+    for (int solve = 0; solve < solves; solve++) {
+        long long pathCells = 0;
+        for (size_t cell = 0; cell < (size_t) rows * columns; cell++)
+            pathCells += matrices[solve][0][cell] > 15;
+        printf("%-12s %-10s cycles %lld, path cells %lld\n", states[solve]->kind == tremauxSolver ? "tremaux" : "random mouse",
+               statusNames[states[solve]->status], states[solve]->totalCycles, pathCells);
+        freeSolverState(states[solve]);
+        freeMatrix(matrices[solve], rows);
+    }
+    printf("%lld calls of %lld moves, longest call %.6f s\n", calls, budget, longestCall);
+    free(states);
+    free(matrices);
+}
+
+/*******************************Laberynth Images*******************************/
+/*
+The laberynth is drawn as a grid of cells of cellPixels x cellPixels pixels separated by walls wallPixels thick,
+so the image has columns * (cellPixels + wallPixels) + wallPixels pixels per line. A wall strip is only drawn
+where the cells on both sides are not joined, the entrance and the exit are gaps in the border.
+The optional overlays paint the cells marked with + 16 (the path left by the solvers) and the distance to the
+exit of every cell (heatmap of computeDistanceField).
+The image is produced in batches of horizontal bands of cells, one band per thread, rendered into one buffer
+that is sent to the file with a single write. The rows of a band come from a fixed budget of bytes for the whole
+batch, so the memory used depends neither on the number of rows nor on the number of threads: a batch is at most
+renderBatchBytes, or one row of cells per thread when the image is so wide that a single row is larger.
+*/
+
+#define renderBatchBytes (64u << 20)
+
+typedef struct {
+    int cellPixels;
+    int wallPixels;
+    bool color;                   // Binary PPM, otherwise binary PGM
+    bool pathOverlay;             // Paint the cells marked with + 16
+    const unsigned int *heatmap;  // Distance field painted under the path, NULL for none
+    int threadCount;              // Threads that render bands, 0 uses one per processor
+} RenderOptions;
+
+typedef struct {
+    int **matrix;
+    int rows;
+    int columns;
+    const RenderOptions *options;
+    int channels;
+    unsigned int maximum;         // Largest reachable distance of the heatmap
+    size_t lineBytes;
+    int batchRows;                // Rows of cells of every batch
+    unsigned char *buffer;        // Pixels of the batch
+    pthread_barrier_t *barrier;
+    int threadCount;
+    int file;
+    bool failed;
+} RenderJob;
+
+typedef struct {
+    RenderJob *job;
+    int thread;
+} RenderWorker;
+
+const unsigned char wallColor[3] = {0, 0, 0};
+const unsigned char floorColor[3] = {255, 255, 255};
+const unsigned char pathColor[3] = {220, 30, 30};
+const unsigned char unreachableColor[3] = {160, 160, 160};
+
+static inline void cellColor(const RenderJob *job, int x, int y, bool onPath, unsigned char *color) {
+    /*
+    Subroutine that chooses the color of the inside of a cell: path, heatmap or floor.
+    */
+    const RenderOptions *options = job->options;
+    if (onPath) {
+        memcpy(color, pathColor, 3);
+    } else if (options->heatmap != NULL) {
+        unsigned int distance = options->heatmap[(size_t) x * job->columns + y];
+        if (distance == unreachableDistance) {
+            memcpy(color, unreachableColor, 3);
+        } else { // Blue next to the exit, yellow at the farthest cell
+            unsigned int level = (unsigned int) ((unsigned long long) distance * 255 / job->maximum);
+            color[0] = (unsigned char) level;
+            color[1] = (unsigned char) (level * 3 / 4);
+            color[2] = (unsigned char) (255 - level);
+        }
+    } else {
+        memcpy(color, floorColor, 3);
+    }
+    if (!options->color) // Luma of the color for PGM
+        color[0] = (unsigned char) ((color[0] * 77 + color[1] * 150 + color[2] * 29) >> 8);
+}
+
+static inline bool markedCell(const RenderJob *job, int x, int y) {
+    return job->options->pathOverlay && job->matrix[x][y] > 15;
+}
+
+static inline void passageColor(const RenderJob *job, int x, int y, int otherX, int otherY, unsigned char *color) {
+    /*
+    Subroutine that chooses the color of an open wall between the cell (x, y) and another cell, which can be
+    outside of the laberynth (entrance and exit): it is part of the path only if both cells are.
+    */
+    bool otherInside = otherX >= 0 && otherX < job->rows && otherY >= 0 && otherY < job->columns;
+    cellColor(job, x, y, markedCell(job, x, y) && (!otherInside || markedCell(job, otherX, otherY)), color);
+}
+
+static inline unsigned char *putPixels(unsigned char *pixel, const unsigned char *color, int count, int channels) {
+    for (int i = 0; i < count; i++) {
+        memcpy(pixel, color, channels);
+        pixel += channels;
+    }
+    return pixel;
+}
+
+void renderWallLine(const RenderJob *job, int x, unsigned char *line) {
+    /*
+    Subroutine that draws one pixel line of the wall strip above the row x of cells (x == rows is the bottom border).
+    */
+    int cellPixels = job->options->cellPixels;
+    int wallPixels = job->options->wallPixels;
+    int channels = job->channels;
+    unsigned char color[3];
+    for (int y = 0; y < job->columns; y++) {
+        line = putPixels(line, wallColor, wallPixels, channels);
+        bool open = x < job->rows ? job->matrix[x][y] % 16 & aboveOpening : job->matrix[x - 1][y] % 16 & belowOpening;
+        if (open) {
+            if (x < job->rows)
+                passageColor(job, x, y, x - 1, y, color);
+            else
+                passageColor(job, x - 1, y, x, y, color);
+            line = putPixels(line, color, cellPixels, channels);
+        } else {
+            line = putPixels(line, wallColor, cellPixels, channels);
+        }
+    }
+    putPixels(line, wallColor, wallPixels, channels);
+}
+
+void renderCellLine(const RenderJob *job, int x, unsigned char *line) {
+    /*
+    Subroutine that draws one pixel line through the inside of the row x of cells.
+    */
+    int cellPixels = job->options->cellPixels;
+    int wallPixels = job->options->wallPixels;
+    int channels = job->channels;
+    unsigned char color[3];
+    for (int y = 0; y <= job->columns; y++) {
+        bool open = y < job->columns ? job->matrix[x][y] % 16 & leftOpening : job->matrix[x][y - 1] % 16 & rightOpening;
+        if (open) {
+            if (y < job->columns)
+                passageColor(job, x, y, x, y - 1, color);
+            else
+                passageColor(job, x, y - 1, x, y, color);
+            line = putPixels(line, color, wallPixels, channels);
+        } else {
+            line = putPixels(line, wallColor, wallPixels, channels);
+        }
+        if (y < job->columns) {
+            cellColor(job, x, y, markedCell(job, x, y), color);
+            line = putPixels(line, color, cellPixels, channels);
+        }
+    }
+}
+
+void renderBand(const RenderJob *job, int firstRow, int lastRow, unsigned char *pixels) {
+    /*
+    Subroutine that draws the rows firstRow .. lastRow - 1 of cells, each one with the wall strip above it, and
+    the bottom border after the last row of the laberynth. Repeated pixel lines are copied.
+    */
+    int cellPixels = job->options->cellPixels;
+    int wallPixels = job->options->wallPixels;
+    size_t lineBytes = job->lineBytes;
+    for (int x = firstRow; x <= lastRow; x++) {
+        if (x == lastRow && x != job->rows)
+            break;
+        renderWallLine(job, x, pixels);
+        for (int line = 1; line < wallPixels; line++)
+            memcpy(pixels + line * lineBytes, pixels, lineBytes);
+        pixels += wallPixels * lineBytes;
+        if (x == job->rows)
+            break;
+        renderCellLine(job, x, pixels);
+        for (int line = 1; line < cellPixels; line++)
+            memcpy(pixels + line * lineBytes, pixels, lineBytes);
+        pixels += cellPixels * lineBytes;
+    }
+}
+
+bool writeAll(int file, const unsigned char *data, size_t bytes) {
+    while (bytes > 0) {
+        ssize_t written = write(file, data, bytes);
+        if (written <= 0)
+            return false;
+        data += written;
+        bytes -= written;
+    }
+    return true;
+}
+
+void *renderThread(void *argument) {
+    /*
+    Subroutine run by every thread: draw its band of each batch, and the first thread writes the batch once all
+    the bands are done.
+    */
+    RenderWorker *worker = argument;
+    RenderJob *job = worker->job;
+    size_t rowBytes = (size_t) (job->options->cellPixels + job->options->wallPixels) * job->lineBytes;
+    int bandRows = job->batchRows / job->threadCount;
+    for (int batchRow = 0; batchRow < job->rows; batchRow += job->batchRows) {
+        int firstRow = batchRow + worker->thread * bandRows;
+        int lastRow = firstRow + bandRows < job->rows ? firstRow + bandRows : job->rows;
+        if (firstRow < lastRow)
+            renderBand(job, firstRow, lastRow, job->buffer + (size_t) (firstRow - batchRow) * rowBytes);
+        pthread_barrier_wait(job->barrier); // Bands drawn
+        if (worker->thread == 0 && !job->failed) {
+            int batchEnd = batchRow + job->batchRows < job->rows ? batchRow + job->batchRows : job->rows;
+            size_t bytes = (size_t) (batchEnd - batchRow) * rowBytes + (batchEnd == job->rows ? job->options->wallPixels * job->lineBytes : 0);
+            job->failed = !writeAll(job->file, job->buffer, bytes);
+        }
+        pthread_barrier_wait(job->barrier); // Buffer free again
+    }
+    return NULL;
+}
+
+bool renderLaberynth(const char *path, int **matrix, int rows, int columns, const RenderOptions *options) {
+    /*
+    Subroutine that draws a laberynth into a binary PGM or PPM image.
+    Inputs and constraints:
+        -path: File to create.
+        -matrix, rows, columns: The laberynth, with the + 16 marks of a solver if the path is painted.
+        -options: Pixel sizes, format, overlays and threads, cellPixels and wallPixels at least 1.
+    Outputs:
+        -true if the image was written.
+    References:
+        -Poskanzer, J. (2016). PPM Format Specification. https://netpbm.sourceforge.net/doc/ppm.html
+    */
+    int file = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (file < 0)
+        return false;
+
+    RenderJob job;
+    job.matrix = matrix;
+    job.rows = rows;
+    job.columns = columns;
+    job.options = options;
+    job.channels = options->color ? 3 : 1;
+    job.maximum = options->heatmap != NULL ? maximumDistance(options->heatmap, (size_t) rows * columns) : 0;
+    if (job.maximum == 0)
+        job.maximum = 1;
+    long long width = (long long) columns * (options->cellPixels + options->wallPixels) + options->wallPixels;
+    long long height = (long long) rows * (options->cellPixels + options->wallPixels) + options->wallPixels;
+    job.lineBytes = (size_t) width * job.channels;
+    size_t rowBytes = (size_t) (options->cellPixels + options->wallPixels) * job.lineBytes;
+    size_t budgetRows = renderBatchBytes / rowBytes > 0 ? renderBatchBytes / rowBytes : 1;
+    if (budgetRows > (size_t) rows)
+        budgetRows = rows;
+    job.threadCount = options->threadCount > 0 ? options->threadCount : threadsAvailable();
+    if ((size_t) job.threadCount > budgetRows) // More threads than rows of cells in the batch
+        job.threadCount = (int) budgetRows;
+    job.batchRows = (int) (budgetRows / job.threadCount) * job.threadCount;
+    job.buffer = malloc((size_t) job.batchRows * rowBytes + options->wallPixels * job.lineBytes);
+    if (job.buffer == NULL) {
+        close(file);
+        return false;
+    }
+    job.file = file;
+    job.failed = false;
+
+    char header[64];
+    int headerBytes = snprintf(header, sizeof(header), "%s\n%lld %lld\n255\n", options->color ? "P6" : "P5", width, height);
+    job.failed = !writeAll(file, (const unsigned char *) header, headerBytes);
+
+    pthread_barrier_t barrier;
+    pthread_barrier_init(&barrier, NULL, job.threadCount);
+    job.barrier = &barrier;
+    RenderWorker *workers = malloc(sizeof(RenderWorker) * job.threadCount);
+    pthread_t *threads = malloc(sizeof(pthread_t) * job.threadCount);
+    for (int thread = 0; thread < job.threadCount; thread++) {
+        workers[thread].job = &job;
+        workers[thread].thread = thread;
+        if (thread > 0)
+            pthread_create(&threads[thread], NULL, renderThread, &workers[thread]);
+    }
+    renderThread(&workers[0]);
+    for (int thread = 1; thread < job.threadCount; thread++)
+        pthread_join(threads[thread], NULL);
+    pthread_barrier_destroy(&barrier);
+
+    free(threads);
+    free(workers);
+    free(job.buffer);
+    return close(file) == 0 && !job.failed;
+}
+
+void renderDemo(int rows, int columns, int cellPixels, int wallPixels, const char *path, const char *overlays, int threadCount) {
+    /*
+    Subroutine that draws a new laberynth, with the path of Tremaux ("p" in overlays) and the distance field
+    ("h" in overlays). The image is PPM if path ends with .ppm, otherwise PGM.
+    */
+    int **matrix = createMatrix(rows, columns);
+    CellLayout layout = createCellLayout(rowMajorLayout, rows, columns);
+    generateLaberynthCells(matrix[0], &layout, 1);
+
+    RenderOptions options = {cellPixels, wallPixels, false, false, NULL, threadCount};
+    size_t length = strlen(path);
+    options.color = length >= 4 && strcmp(path + length - 4, ".ppm") == 0;
+    unsigned int *distance = NULL;
+    if (strchr(overlays, 'h') != NULL) {
+        distance = computeDistanceField(matrix, rows, columns, threadCount);
+        options.heatmap = distance;
+    }
+    if (strchr(overlays, 'p') != NULL) {
+        SolverState *state = createSolverState(tremauxSolver, matrix, rows, columns, 1);
+        while (stepSolver(state, 1LL << 40) == solverInProgress);
+        freeSolverState(state);
+        options.pathOverlay = true;
+    }
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    bool written = renderLaberynth(path, matrix, rows, columns, &options);
+    double seconds = elapsedSeconds(start);
+    if (written)
+        printf("%s: %d x %d cells rendered in %.3f s\n", path, rows, columns, seconds);
+    else
+        printf("Could not write %s\n", path);
+    releaseLargeBlock(distance);
+    freeMatrix(matrix, rows);
+}
+
+/*******************************Job Server*******************************/
+/*
+Long running server that generates and solves laberynths for other processes through a Unix domain socket, so
+they do not pay for a new process per laberynth and they get structured results.
+Every connection sends one request per line:
+// job rows columns seed generator solver format [timeoutMilliseconds]
+//     generator: prim ; solver: tremaux, mouse or none ; format: json or binary
+// stats ; Queue depth, jobs done and latency percentiles as JSON
+// shutdown ; Stops the server once the queued jobs are done
+Replies are written when the jobs finish, maybe in a different order than the requests, and carry the number of
+the request inside its connection. A json reply is one line, a binary reply is a ServerReplyHeader followed by
+the nibbles of the laberynth (two cells per byte, the low nibble first) and one bit per cell of the solver path.
+Jobs are spread over the deques of the workers. A worker takes the newest job of its own deque and, when it is
+empty, steals the oldest job of another deque. Every worker keeps an arena that holds everything a job needs: the
+laberynth, the generator with its frontier and dirty maps (the same memory holds the solver state and the way back
+of Tremaux once the laberynth is generated) and the reply. The only allocation per job outside the arena is the
+small ServerJob of the request, made by the thread that reads the connection before any worker takes it. The
+arena grows to the biggest job the worker has run, up to serverArenaKeepBytes; after a bigger job it is released,
+so one huge job does not pin its memory in the worker for the life of the server. A job that does not fit in memory
+gets an "out of memory" error instead of stopping the server.
+*/
+
+#define serverLatencySamples 4096
+#define serverMaxCells (1LL << 28)
+#define serverSolverSlice (1LL << 20) // Moves between checks of the connection
+#define serverLineSize 256
+#define serverArenaKeepBytes (256ULL << 20) // Bigger arenas are released after their job
+
+typedef struct {
+    char magic[4];             // "LABR"
+    unsigned int id;
+    int status;                // solverSolved, ... , -1 for an error
+    unsigned int rows;
+    unsigned int columns;
+    unsigned int reserved;
+    long long cycles;
+    long long pathCells;
+    unsigned long long payloadBytes;
+} ServerReplyHeader;
+
+typedef struct ServerConnection {
+    int socket;
+    pthread_mutex_t writeLock; // Replies of different workers are not mixed
+    int references;            // Reader thread plus queued jobs, the last one closes the socket
+    int closed;                // The client went away, its jobs are cancelled
+    struct ServerConnection *previous; // Connections with a reader thread, to stop them at shutdown
+    struct ServerConnection *next;
+} ServerConnection;
+
+typedef struct {
+    ServerConnection *connection;
+    unsigned int id;
+    int rows;
+    int columns;
+    unsigned long long seed;
+    int solver;                // randomMouseSolver, tremauxSolver or -1
+    bool binary;
+    int timeoutMilliseconds;   // 0 without deadline
+    struct timespec submitted;
+} ServerJob;
+
+typedef struct {
+    pthread_mutex_t lock;
+    ServerJob **jobs;          // Circular buffer
+    int first;
+    int size;
+    int capacity;
+} JobDeque;
+
+typedef struct {
+    unsigned char *memory;
+    size_t used;
+    size_t capacity;
+} WorkerArena;
+
+typedef struct JobServer JobServer;
+
+typedef struct {
+    JobServer *server;
+    int thread;
+    JobDeque deque;
+    WorkerArena arena;
+    unsigned int randomState;  // Victims of the steals
+} ServerWorker;
+
+struct JobServer {
+    int listener;
+    int workerCount;
+    ServerWorker *workers;
+    pthread_t *threads;
+    pthread_mutex_t lock;
+    pthread_cond_t jobsAvailable;
+    pthread_cond_t readersDone;
+    ServerConnection *connections;
+    int readers;
+    int queued;                // Jobs in the deques
+    int running;
+    bool stopping;
+    unsigned int nextWorker;
+    long long completed;
+    long long latency[serverLatencySamples]; // Microseconds from the request to the reply, circular
+};
+
+void pushJob(JobDeque *deque, ServerJob *job) {
+    pthread_mutex_lock(&deque->lock);
+    if (deque->size == deque->capacity) {
+        int capacity = deque->capacity > 0 ? deque->capacity * 2 : 64;
+        ServerJob **jobs = malloc(sizeof(ServerJob *) * capacity);
+        for (int i = 0; i < deque->size; i++)
+            jobs[i] = deque->jobs[(deque->first + i) % deque->capacity];
+        free(deque->jobs);
+        deque->jobs = jobs;
+        deque->first = 0;
+        deque->capacity = capacity;
+    }
+    deque->jobs[(deque->first + deque->size) % deque->capacity] = job;
+    deque->size++;
+    pthread_mutex_unlock(&deque->lock);
+}
+
+ServerJob *popNewestJob(JobDeque *deque) {
+    ServerJob *job = NULL;
+    pthread_mutex_lock(&deque->lock);
+    if (deque->size > 0) {
+        deque->size--;
+        job = deque->jobs[(deque->first + deque->size) % deque->capacity];
+    }
+    pthread_mutex_unlock(&deque->lock);
+    return job;
+}
+
+ServerJob *stealOldestJob(JobDeque *deque) {
+    ServerJob *job = NULL;
+    pthread_mutex_lock(&deque->lock);
+    if (deque->size > 0) {
+        job = deque->jobs[deque->first];
+        deque->first = (deque->first + 1) % deque->capacity;
+        deque->size--;
+    }
+    pthread_mutex_unlock(&deque->lock);
+    return job;
+}
+
+void *arenaAllocate(WorkerArena *arena, size_t bytes) {
+    /*
+    Subroutine that takes memory from the arena of a worker, everything is given back at once by resetting used.
+    The arena only grows when it is empty, so the blocks already given stay valid.
+    Outputs:
+        -The memory, or NULL if it does not fit and the arena can not grow.
+    */
+    bytes = (bytes + 15) & ~(size_t) 15;
+    if (arena->used + bytes > arena->capacity) {
+        if (arena->used > 0)
+            return NULL;
+        free(arena->memory);
+        arena->memory = malloc(bytes);
+        arena->capacity = arena->memory != NULL ? bytes : 0;
+        if (arena->memory == NULL)
+            return NULL;
+    }
+    void *memory = arena->memory + arena->used;
+    arena->used += bytes;
+    return memory;
+}
+
+void releaseConnection(ServerConnection *connection) {
+    if (__atomic_sub_fetch(&connection->references, 1, __ATOMIC_ACQ_REL) == 0) {
+        close(connection->socket);
+        pthread_mutex_destroy(&connection->writeLock);
+        free(connection);
+    }
+}
+
+void sendReply(ServerConnection *connection, const void *data, size_t bytes) {
+    /*
+    Subroutine that writes a whole reply, a client that went away is marked closed instead of raising SIGPIPE.
+    */
+    pthread_mutex_lock(&connection->writeLock);
+    const char *pending = data;
+    while (bytes > 0 && !__atomic_load_n(&connection->closed, __ATOMIC_RELAXED)) {
+        ssize_t written = send(connection->socket, pending, bytes, MSG_NOSIGNAL);
+        if (written <= 0) {
+            __atomic_store_n(&connection->closed, 1, __ATOMIC_RELAXED);
+            break;
+        }
+        pending += written;
+        bytes -= written;
+    }
+    pthread_mutex_unlock(&connection->writeLock);
+}
+
+void sendError(ServerConnection *connection, unsigned int id, const char *message) {
+    char reply[serverLineSize];
+    int bytes = snprintf(reply, sizeof(reply), "{\"id\":%u,\"error\":\"%s\"}\n", id, message);
+    sendReply(connection, reply, bytes);
+}
+
+long long microsecondsSince(struct timespec start) {
+    return (long long) (elapsedSeconds(start) * 1e6);
+}
+
+size_t serverScratchBytes(const ServerJob *job) {
+    /*
+    Subroutine that gives the memory shared by the generator and then the solver of a job.
+    */
+    CellLayout layout = createCellLayout(rowMajorLayout, job->rows, job->columns);
+    size_t generatorBytes = laberynthGeneratorBytes(&layout);
+    size_t solverBytes = job->solver >= 0 ? solverStateBytes(job->solver, job->rows, job->columns) : 0;
+    return generatorBytes > solverBytes ? generatorBytes : solverBytes;
+}
+
+void solveServerJob(ServerWorker *worker, ServerJob *job, size_t payloadBytes, long long queueMicroseconds, struct timespec start) {
+    /*
+    Subroutine that generates the laberynth of a job in the arena of the worker, already big enough for it, solves
+    it in slices of moves so a closed connection cancels it, and sends the reply.
+    */
+    ServerConnection *connection = job->connection;
+    size_t totalCells = (size_t) job->rows * job->columns;
+    int **matrix = arenaAllocate(&worker->arena, sizeof(int *) * job->rows);
+    matrix[0] = arenaAllocate(&worker->arena, sizeof(int) * totalCells);
+    for (int x = 1; x < job->rows; x++)
+        matrix[x] = matrix[0] + (size_t) x * job->columns;
+    CellLayout layout = createCellLayout(rowMajorLayout, job->rows, job->columns);
+    void *scratch = arenaAllocate(&worker->arena, serverScratchBytes(job));
+    generateLaberynthCellsWithBuffer(matrix[0], &layout, job->seed, scratch);
+
+    int status = solverSolved;
+    long long cycles = 0;
+    if (job->solver >= 0) {
+        // The generator is not needed any more, the solve takes its memory
+        SolverState *state = createSolverStateWithBuffer(job->solver, matrix, job->rows, job->columns, job->seed, scratch);
+        if (job->timeoutMilliseconds > 0)
+            setSolverDeadline(state, job->timeoutMilliseconds / 1000.0);
+        while (stepSolver(state, serverSolverSlice) == solverInProgress) {
+            if (__atomic_load_n(&connection->closed, __ATOMIC_RELAXED))
+                cancelSolver(state);
+        }
+        status = state->status;
+        cycles = state->totalCycles;
+        freeSolverState(state);
+    }
+    long long pathCells = 0;
+    for (size_t cell = 0; cell < totalCells; cell++)
+        pathCells += matrix[0][cell] > 15;
+    long long runMicroseconds = microsecondsSince(start);
+
+    if (job->binary) {
+        ServerReplyHeader *header = arenaAllocate(&worker->arena, sizeof(ServerReplyHeader) + payloadBytes);
+        unsigned char *nibbles = (unsigned char *) (header + 1);
+        unsigned char *path = nibbles + (totalCells + 1) / 2;
+        memset(nibbles, 0, payloadBytes);
+        for (size_t cell = 0; cell < totalCells; cell++) {
+            nibbles[cell >> 1] |= (matrix[0][cell] % 16) << ((cell & 1) * 4);
+            path[cell >> 3] |= (matrix[0][cell] > 15) << (cell & 7);
+        }
+        memcpy(header->magic, "LABR", 4);
+        header->id = job->id;
+        header->status = status;
+        header->rows = job->rows;
+        header->columns = job->columns;
+        header->reserved = 0;
+        header->cycles = cycles;
+        header->pathCells = pathCells;
+        header->payloadBytes = payloadBytes;
+        sendReply(connection, header, sizeof(ServerReplyHeader) + payloadBytes);
+    } else {
+        const char *statusNames[] = {"in progress", "solved", "cancelled", "timed out", "failed"};
+        const char *solverNames[] = {"mouse", "tremaux"};
+        char reply[2 * serverLineSize];
+        int bytes = snprintf(reply, sizeof(reply),
+                             "{\"id\":%u,\"status\":\"%s\",\"rows\":%d,\"columns\":%d,\"seed\":%llu,\"generator\":\"prim\",\"solver\":\"%s\","
+                             "\"cycles\":%lld,\"pathCells\":%lld,\"queueMicroseconds\":%lld,\"runMicroseconds\":%lld}\n",
+                             job->id, job->solver >= 0 ? statusNames[status] : "generated", job->rows, job->columns, job->seed,
+                             job->solver >= 0 ? solverNames[job->solver] : "none", cycles, pathCells, queueMicroseconds, runMicroseconds);
+        sendReply(connection, reply, bytes);
+    }
+}
+
+void runServerJob(ServerWorker *worker, ServerJob *job) {
+    /*
+    Subroutine that grows the arena of the worker to the size of a job, runs it and counts it as done. A job that
+    does not fit in memory gets an error reply.
+    */
+    long long queueMicroseconds = microsecondsSince(job->submitted);
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    ServerConnection *connection = job->connection;
+    size_t totalCells = (size_t) job->rows * job->columns;
+
+    worker->arena.used = 0;
+    size_t payloadBytes = (totalCells + 1) / 2 + (totalCells + 7) / 8;
+    size_t neededBytes = sizeof(int *) * job->rows + sizeof(int) * totalCells + serverScratchBytes(job)
+        + sizeof(ServerReplyHeader) + payloadBytes + 4 * 16; // 16 bytes of alignment per block
+    if (arenaAllocate(&worker->arena, neededBytes) == NULL) { // Grows the arena once for the whole job
+        sendError(connection, job->id, "out of memory");
+    } else {
+        worker->arena.used = 0;
+        solveServerJob(worker, job, payloadBytes, queueMicroseconds, start);
+    }
+    worker->arena.used = 0;
+    if (worker->arena.capacity > serverArenaKeepBytes) { // High water trim
+        free(worker->arena.memory);
+        worker->arena.memory = NULL;
+        worker->arena.capacity = 0;
+    }
+
+    JobServer *server = worker->server;
+    pthread_mutex_lock(&server->lock);
+    server->latency[server->completed % serverLatencySamples] = microsecondsSince(job->submitted);
+    server->completed++;
+    server->running--;
+    if (server->stopping && server->running == 0)
+        pthread_cond_broadcast(&server->jobsAvailable);
+    pthread_mutex_unlock(&server->lock);
+    releaseConnection(connection);
+    free(job);
+}
+
+ServerJob *takeServerJob(ServerWorker *worker) {
+    /*
+    Subroutine that waits for a job: the newest of the own deque, or the oldest of the other deques starting at a
+    random one. Outputs NULL when the server stops and there are no jobs left.
+    */
+    JobServer *server = worker->server;
+    pthread_mutex_lock(&server->lock);
+    while (server->queued == 0 && (!server->stopping || server->running > 0))
+        pthread_cond_wait(&server->jobsAvailable, &server->lock);
+    if (server->queued == 0) {
+        pthread_mutex_unlock(&server->lock);
+        return NULL;
+    }
+    server->queued--; // One of the deques holds a job for this worker
+    server->running++;
+    pthread_mutex_unlock(&server->lock);
+
+    while (true) {
+        ServerJob *job = popNewestJob(&worker->deque);
+        if (job != NULL)
+            return job;
+        worker->randomState = worker->randomState * 1103515245u + 12345u;
+        int victim = (worker->randomState >> 16) % server->workerCount;
+        for (int i = 0; i < server->workerCount && job == NULL; i++)
+            job = stealOldestJob(&server->workers[(victim + i) % server->workerCount].deque);
+        if (job != NULL)
+            return job;
+    }
+}
+
+void *serverWorkerThread(void *argument) {
+    ServerWorker *worker = argument;
+    ServerJob *job;
+    while ((job = takeServerJob(worker)) != NULL)
+        runServerJob(worker, job);
+    return NULL;
+}
+
+bool submitServerJob(JobServer *server, ServerJob *job) {
+    pthread_mutex_lock(&server->lock);
+    if (server->stopping) { // The workers may be gone already
+        pthread_mutex_unlock(&server->lock);
+        return false;
+    }
+    ServerWorker *worker = &server->workers[server->nextWorker++ % server->workerCount];
+    server->running++; // Keeps the workers alive until the job is counted as queued
+    pthread_mutex_unlock(&server->lock);
+    __atomic_add_fetch(&job->connection->references, 1, __ATOMIC_ACQ_REL);
+    pushJob(&worker->deque, job);
+    pthread_mutex_lock(&server->lock);
+    server->running--;
+    server->queued++;
+    pthread_cond_signal(&server->jobsAvailable);
+    pthread_mutex_unlock(&server->lock);
+    return true;
+}
+
+int compareLatencies(const void *first, const void *second) {
+    long long a = *(const long long *) first;
+    long long b = *(const long long *) second;
+    return (a > b) - (a < b);
+}
+
+void sendServerStats(JobServer *server, ServerConnection *connection) {
+    /*
+    Subroutine that replies the queue depth, the jobs done and the percentiles of the latency of the last
+    serverLatencySamples jobs.
+    */
+    long long samples[serverLatencySamples];
+    pthread_mutex_lock(&server->lock);
+    int queued = server->queued;
+    int running = server->running;
+    long long completed = server->completed;
+    int sampleCount = completed < serverLatencySamples ? (int) completed : serverLatencySamples;
+    memcpy(samples, server->latency, sizeof(long long) * sampleCount);
+    pthread_mutex_unlock(&server->lock);
+
+    qsort(samples, sampleCount, sizeof(long long), compareLatencies);
+    long long percentile[3] = {0, 0, 0};
+    const int percent[3] = {50, 90, 99};
+    for (int i = 0; i < 3 && sampleCount > 0; i++)
+        percentile[i] = samples[(sampleCount - 1) * percent[i] / 100];
+    char reply[serverLineSize];
+    int bytes = snprintf(reply, sizeof(reply),
+                         "{\"queued\":%d,\"running\":%d,\"completed\":%lld,\"workers\":%d,\"p50Microseconds\":%lld,\"p90Microseconds\":%lld,\"p99Microseconds\":%lld}\n",
+                         queued, running, completed, server->workerCount, percentile[0], percentile[1], percentile[2]);
+    sendReply(connection, reply, bytes);
+}
+
+void handleServerRequest(JobServer *server, ServerConnection *connection, unsigned int id, char *line) {
+    char command[16] = "";
+    sscanf(line, "%15s", command);
+    if (strcmp(command, "stats") == 0) {
+        sendServerStats(server, connection);
+    } else if (strcmp(command, "shutdown") == 0) {
+        pthread_mutex_lock(&server->lock);
+        server->stopping = true;
+        pthread_mutex_unlock(&server->lock);
+        shutdown(server->listener, SHUT_RDWR); // Wakes up accept
+    } else if (strcmp(command, "job") == 0) {
+        ServerJob job = {connection, id, 0, 0, 0, -1, false, 0, {0, 0}};
+        char generator[16], solver[16], format[16];
+        int fields = sscanf(line, "%*s %d %d %llu %15s %15s %15s %d", &job.rows, &job.columns, &job.seed, generator, solver, format,
+                            &job.timeoutMilliseconds);
+        if (fields < 6) {
+            sendError(connection, id, "expected: job rows columns seed generator solver format [timeoutMilliseconds]");
+            return;
+        }
+        if (job.rows <= 0 || job.columns <= 0 || (long long) job.rows * job.columns > serverMaxCells) {
+            sendError(connection, id, "invalid size");
+            return;
+        }
+        if (strcmp(generator, "prim") != 0) {
+            sendError(connection, id, "unknown generator");
+            return;
+        }
+        if (strcmp(solver, "tremaux") == 0)
+            job.solver = tremauxSolver;
+        else if (strcmp(solver, "mouse") == 0)
+            job.solver = randomMouseSolver;
+        else if (strcmp(solver, "none") != 0) {
+            sendError(connection, id, "unknown solver");
+            return;
+        }
+        if (strcmp(format, "binary") != 0 && strcmp(format, "json") != 0) {
+            sendError(connection, id, "unknown format");
+            return;
+        }
+        job.binary = format[0] == 'b';
+        clock_gettime(CLOCK_MONOTONIC, &job.submitted);
+        ServerJob *queuedJob = malloc(sizeof(ServerJob));
+        *queuedJob = job;
+        if (!submitServerJob(server, queuedJob)) {
+            free(queuedJob);
+            sendError(connection, id, "server stopping");
+        }
+    } else if (command[0] != '\0') {
+        sendError(connection, id, "unknown command");
+    }
+}
+
+typedef struct {
+    JobServer *server;
+    ServerConnection *connection;
+} ServerReader;
+
+void *serverReaderThread(void *argument) {
+    /*
+    Subroutine that reads the requests of one connection line by line until the client closes it.
+    */
+    ServerReader *reader = argument;
+    ServerConnection *connection = reader->connection;
+    char buffer[serverLineSize];
+    int used = 0;
+    unsigned int id = 0;
+    while (true) {
+        ssize_t received = recv(connection->socket, buffer + used, sizeof(buffer) - 1 - used, 0);
+        if (received <= 0)
+            break;
+        used += received;
+        char *lineStart = buffer;
+        char *lineEnd;
+        while ((lineEnd = memchr(lineStart, '\n', buffer + used - lineStart)) != NULL) {
+            *lineEnd = '\0';
+            handleServerRequest(reader->server, connection, id++, lineStart);
+            lineStart = lineEnd + 1;
+        }
+        used -= lineStart - buffer;
+        memmove(buffer, lineStart, used);
+        if (used == (int) sizeof(buffer) - 1) { // Line too long
+            sendError(connection, id++, "line too long");
+            used = 0;
+        }
+    }
+    __atomic_store_n(&connection->closed, 1, __ATOMIC_RELAXED);
+    JobServer *server = reader->server;
+    pthread_mutex_lock(&server->lock);
+    if (connection->previous != NULL)
+        connection->previous->next = connection->next;
+    else
+        server->connections = connection->next;
+    if (connection->next != NULL)
+        connection->next->previous = connection->previous;
+    server->readers--;
+    pthread_cond_signal(&server->readersDone);
+    pthread_mutex_unlock(&server->lock);
+    releaseConnection(connection);
+    free(reader);
+    return NULL;
+}
+
+int runJobServer(const char *socketPath, int workerCount) {
+    /*
+    Subroutine that serves jobs on a Unix domain socket until a client sends shutdown.
+    Inputs and constraints:
+        -socketPath: Path of the socket, an old socket file is replaced.
+        -workerCount: Threads that run jobs, 0 uses one per processor.
+    Outputs:
+        -0 after a shutdown, 1 if the socket could not be opened.
+    References:
+        -Blumofe, R. D., & Leiserson, C. E. (1999). Scheduling multithreaded computations by work stealing. JACM 46(5).
+    */
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(socketPath) >= sizeof(address.sun_path)) {
+        fprintf(stderr, "Socket path too long\n");
+        return 1;
+    }
+    strcpy(address.sun_path, socketPath);
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(socketPath);
+    if (listener < 0 || bind(listener, (struct sockaddr *) &address, sizeof(address)) != 0 || listen(listener, 64) != 0) {
+        fprintf(stderr, "Could not listen on %s\n", socketPath);
+        if (listener >= 0)
+            close(listener);
+        return 1;
+    }
+
+    JobServer *server = calloc(1, sizeof(JobServer));
+    server->listener = listener;
+    server->workerCount = workerCount > 0 ? workerCount : threadsAvailable();
+    server->workers = calloc(server->workerCount, sizeof(ServerWorker));
+    server->threads = malloc(sizeof(pthread_t) * server->workerCount);
+    pthread_mutex_init(&server->lock, NULL);
+    pthread_cond_init(&server->jobsAvailable, NULL);
+    pthread_cond_init(&server->readersDone, NULL);
+    for (int thread = 0; thread < server->workerCount; thread++) {
+        ServerWorker *worker = &server->workers[thread];
+        worker->server = server;
+        worker->thread = thread;
+        worker->randomState = thread + 1;
+        pthread_mutex_init(&worker->deque.lock, NULL);
+        pthread_create(&server->threads[thread], NULL, serverWorkerThread, worker);
+    }
+    printf("Serving on %s with %d workers\n", socketPath, server->workerCount);
+    fflush(stdout);
+
+    while (true) {
+        int client = accept(listener, NULL, NULL);
+        pthread_mutex_lock(&server->lock);
+        bool stopping = server->stopping;
+        pthread_mutex_unlock(&server->lock);
+        if (stopping) {
+            if (client >= 0)
+                close(client);
+            break;
+        }
+        if (client < 0)
+            continue;
+        ServerConnection *connection = calloc(1, sizeof(ServerConnection));
+        connection->socket = client;
+        connection->references = 1;
+        pthread_mutex_init(&connection->writeLock, NULL);
+        ServerReader *reader = malloc(sizeof(ServerReader));
+        reader->server = server;
+        reader->connection = connection;
+        pthread_mutex_lock(&server->lock);
+        connection->next = server->connections;
+        if (connection->next != NULL)
+            connection->next->previous = connection;
+        server->connections = connection;
+        server->readers++;
+        pthread_mutex_unlock(&server->lock);
+        pthread_t thread;
+        pthread_create(&thread, NULL, serverReaderThread, reader);
+        pthread_detach(thread);
+    }
+
+    pthread_mutex_lock(&server->lock);
+    pthread_cond_broadcast(&server->jobsAvailable);
+    pthread_mutex_unlock(&server->lock);
+    for (int thread = 0; thread < server->workerCount; thread++) {
+        pthread_join(server->threads[thread], NULL);
+        free(server->workers[thread].deque.jobs);
+        free(server->workers[thread].arena.memory);
+        pthread_mutex_destroy(&server->workers[thread].deque.lock);
+    }
+    pthread_mutex_lock(&server->lock); // The replies are sent, stop the readers of the open connections
+    for (ServerConnection *connection = server->connections; connection != NULL; connection = connection->next)
+        shutdown(connection->socket, SHUT_RDWR);
+    while (server->readers > 0)
+        pthread_cond_wait(&server->readersDone, &server->lock);
+    pthread_mutex_unlock(&server->lock);
+    close(listener);
+    unlink(socketPath);
+    printf("Served %lld jobs\n", server->completed);
+    pthread_cond_destroy(&server->jobsAvailable);
+    pthread_cond_destroy(&server->readersDone);
+    pthread_mutex_destroy(&server->lock);
+    free(server->threads);
+    free(server->workers);
+    free(server);
+    return 0;
+}
+
+/*******************************Hierarchical Planner*******************************/
+/*
+Once a laberynth has loops (braidLaberynth, or walls removed by hand) there is more than one way to the exit, and
+a search over the whole grid visits a large part of it. The grid is split in clusters of clusterSize x clusterSize
+cells. The border cells of a cluster with an opening into another cluster are its entrances, and a breadth first
+search inside the cluster from every entrance gives the table of distances between its entrances.
+A query is an A* search over the entrances only: from an entrance it goes to the other entrances of its cluster
+using the table, or through the opening to the entrance of the next cluster. The start and the goal are joined to
+the entrances of their clusters with one search inside each cluster. The path found is then refined into cells
+with a search inside every cluster it crosses.
+Every border cell has a fixed slot in its cluster (top row, bottom row, left column, right column), so the node of
+an entrance is cluster * slotsPerCluster + slot and changing a wall only rebuilds the clusters of its two cells.
+References:
+    -Botea, A., Muller, M., & Schaeffer, J. (2004). Near optimal hierarchical path-finding. Journal of Game Development, 1(1).
+*/
+
+#define maxClusterSize 64
+#define noEntrance 255
+#define clusterUnreachable 0xFFFF
+
+typedef struct {
+    unsigned char *openings;   // Openings of the cells of the cluster that stay inside it
+    unsigned short *distance;  // clusterSize * clusterSize cells of the cluster
+    int *queue;
+    unsigned char *back;       // Direction of every cell towards the cell the search started from
+} ClusterScratch;
+
+typedef struct {
+    int **matrix;
+    int rows;
+    int columns;
+    int clusterSize;
+    int clusterRows;
+    int clusterColumns;
+    int slotsPerCluster;
+    unsigned char *slotEntrance;           // Entrance of every slot, noEntrance for the other slots
+    int *entranceCount;
+    unsigned short **entranceSlot;         // Slots of the entrances of every cluster
+    unsigned short **entranceDistance;     // entranceCount^2 distances inside the cluster of every cluster
+    // Query state, reused by every query
+    int *cost;
+    int *parent;
+    unsigned int *stamp;                   // Query that wrote cost and parent of every node
+    unsigned int query;
+    unsigned short *goalDistance;          // Distance from every entrance of the goal cluster to the goal
+    int *abstractPath;                     // Nodes of the last path, the goal cell last
+    int abstractPathSize;
+    bool pathFound;                        // The last query found a path and no wall changed since
+    int startX, startY, goalX, goalY;
+    ClusterScratch scratch;
+} HierarchicalPlanner;
+
+typedef struct {
+    int top;
+    int left;
+    int height;
+    int width;
+} ClusterBounds;
+
+static inline ClusterBounds clusterBounds(const HierarchicalPlanner *planner, int cluster) {
+    ClusterBounds bounds;
+    bounds.top = cluster / planner->clusterColumns * planner->clusterSize;
+    bounds.left = cluster % planner->clusterColumns * planner->clusterSize;
+    bounds.height = planner->rows - bounds.top < planner->clusterSize ? planner->rows - bounds.top : planner->clusterSize;
+    bounds.width = planner->columns - bounds.left < planner->clusterSize ? planner->columns - bounds.left : planner->clusterSize;
+    return bounds;
+}
+
+static inline int cellCluster(const HierarchicalPlanner *planner, int x, int y) {
+    return x / planner->clusterSize * planner->clusterColumns + y / planner->clusterSize;
+}
+
+static inline int borderSlot(const HierarchicalPlanner *planner, ClusterBounds bounds, int x, int y) {
+    /*
+    Subroutine that gives the slot of a border cell of a cluster, or -1 for the cells inside it.
+    */
+    int localX = x - bounds.top;
+    int localY = y - bounds.left;
+    int size = planner->clusterSize;
+    if (localX == 0) return localY;
+    if (localX == bounds.height - 1) return size + localY;
+    if (localY == 0) return 2 * size + localX;
+    if (localY == bounds.width - 1) return 3 * size + localX;
+    return -1;
+}
+
+static inline void slotCell(const HierarchicalPlanner *planner, ClusterBounds bounds, int slot, int *x, int *y) {
+    int size = planner->clusterSize;
+    if (slot < size) {
+        *x = bounds.top;
+        *y = bounds.left + slot;
+    } else if (slot < 2 * size) {
+        *x = bounds.top + bounds.height - 1;
+        *y = bounds.left + slot - size;
+    } else if (slot < 3 * size) {
+        *x = bounds.top + slot - 2 * size;
+        *y = bounds.left;
+    } else {
+        *x = bounds.top + slot - 3 * size;
+        *y = bounds.left + bounds.width - 1;
+    }
+}
+
+void createClusterScratch(ClusterScratch *scratch, int clusterSize) {
+    scratch->openings = malloc(clusterSize * clusterSize);
+    scratch->distance = malloc(sizeof(unsigned short) * clusterSize * clusterSize);
+    scratch->queue = malloc(sizeof(int) * clusterSize * clusterSize);
+    scratch->back = malloc(clusterSize * clusterSize);
+}
+
+void freeClusterScratch(ClusterScratch *scratch) {
+    free(scratch->openings);
+    free(scratch->distance);
+    free(scratch->queue);
+    free(scratch->back);
+}
+
+void loadClusterOpenings(const HierarchicalPlanner *planner, ClusterBounds bounds, ClusterScratch *scratch) {
+    /*
+    Subroutine that copies the openings of the cells of a cluster without the ones that leave it, so the searches
+    inside the cluster do not check the borders.
+    */
+    for (int localX = 0; localX < bounds.height; localX++) {
+        const int *row = planner->matrix[bounds.top + localX] + bounds.left;
+        unsigned char *openings = scratch->openings + localX * bounds.width;
+        for (int localY = 0; localY < bounds.width; localY++)
+            openings[localY] = row[localY] % 16;
+        openings[0] &= ~leftOpening;
+        openings[bounds.width - 1] &= ~rightOpening;
+    }
+    for (int localY = 0; localY < bounds.width; localY++) {
+        scratch->openings[localY] &= ~aboveOpening;
+        scratch->openings[(bounds.height - 1) * bounds.width + localY] &= ~belowOpening;
+    }
+}
+
+void clusterBreadthFirst(ClusterBounds bounds, int startX, int startY, ClusterScratch *scratch) {
+    /*
+    Subroutine that computes the distance from a cell to every cell of its cluster moving only inside the cluster,
+    and the direction of every cell towards the start. The openings of the cluster must be loaded.
+    */
+    int cells = bounds.height * bounds.width;
+    for (int local = 0; local < cells; local++)
+        scratch->distance[local] = clusterUnreachable;
+    int startLocal = (startX - bounds.top) * bounds.width + startY - bounds.left;
+    const int step[4] = {-bounds.width, bounds.width, -1, 1};
+    scratch->distance[startLocal] = 0;
+    scratch->queue[0] = startLocal;
+    int head = 0, tail = 1;
+    while (head < tail) {
+        int local = scratch->queue[head++];
+        int openings = scratch->openings[local];
+        for (int direction = 0; direction < 4; direction++) {
+            int newLocal = local + step[direction];
+            if ((openings & directionOpening[direction]) && scratch->distance[newLocal] == clusterUnreachable) {
+                scratch->distance[newLocal] = scratch->distance[local] + 1;
+                scratch->back[newLocal] = directionOpposite[direction];
+                scratch->queue[tail++] = newLocal;
+            }
+        }
+    }
+}
+
+void buildCluster(HierarchicalPlanner *planner, int cluster, ClusterScratch *scratch) {
+    /*
+    Subroutine that finds the entrances of a cluster and the distances between them, replacing the old ones.
+    */
+    ClusterBounds bounds = clusterBounds(planner, cluster);
+    unsigned char *slotEntrance = planner->slotEntrance + (size_t) cluster * planner->slotsPerCluster;
+    memset(slotEntrance, noEntrance, planner->slotsPerCluster);
+    free(planner->entranceSlot[cluster]);
+    free(planner->entranceDistance[cluster]);
+
+    unsigned short slots[4 * maxClusterSize];
+    int count = 0;
+    for (int x = bounds.top; x < bounds.top + bounds.height; x++) {
+        bool borderRow = x == bounds.top || x == bounds.top + bounds.height - 1;
+        for (int y = bounds.left; y < bounds.left + bounds.width; y += borderRow || bounds.width == 1 ? 1 : bounds.width - 1) {
+            int openings = insideOpenings(planner->matrix, planner->rows, planner->columns, x, y);
+            for (int direction = 0; direction < 4; direction++) {
+                if ((openings & directionOpening[direction])
+                    && cellCluster(planner, x + directionRowStep[direction], y + directionColumnStep[direction]) != cluster) {
+                    int slot = borderSlot(planner, bounds, x, y);
+                    slotEntrance[slot] = count;
+                    slots[count++] = slot;
+                    break;
+                }
+            }
+        }
+    }
+
+    planner->entranceCount[cluster] = count;
+    planner->entranceSlot[cluster] = malloc(sizeof(unsigned short) * (count > 0 ? count : 1));
+    planner->entranceDistance[cluster] = malloc(sizeof(unsigned short) * (count > 0 ? count * count : 1));
+    memcpy(planner->entranceSlot[cluster], slots, sizeof(unsigned short) * count);
+    loadClusterOpenings(planner, bounds, scratch);
+    for (int entrance = 0; entrance < count; entrance++) {
+        int x, y;
+        slotCell(planner, bounds, slots[entrance], &x, &y);
+        clusterBreadthFirst(bounds, x, y, scratch);
+        for (int other = 0; other < count; other++) {
+            int otherX, otherY;
+            slotCell(planner, bounds, slots[other], &otherX, &otherY);
+            planner->entranceDistance[cluster][entrance * count + other] =
+                scratch->distance[(otherX - bounds.top) * bounds.width + otherY - bounds.left];
+        }
+    }
+}
+
+typedef struct {
+    HierarchicalPlanner *planner;
+    int nextCluster;
+} ClusterBuildJob;
+
+void *clusterBuildThread(void *argument) {
+    ClusterBuildJob *job = argument;
+    HierarchicalPlanner *planner = job->planner;
+    ClusterScratch scratch;
+    createClusterScratch(&scratch, planner->clusterSize);
+    int clusters = planner->clusterRows * planner->clusterColumns;
+    while (true) {
+        int cluster = __atomic_fetch_add(&job->nextCluster, 1, __ATOMIC_RELAXED);
+        if (cluster >= clusters)
+            break;
+        buildCluster(planner, cluster, &scratch);
+    }
+    freeClusterScratch(&scratch);
+    return NULL;
+}
+
+HierarchicalPlanner *createHierarchicalPlanner(int **matrix, int rows, int columns, int clusterSize, int threadCount) {
+    /*
+    Subroutine that splits a laberynth in clusters and builds the entrances and distance tables of all of them in
+    parallel.
+    Inputs and constraints:
+        -matrix, rows, columns: The laberynth, it can have loops. It is kept by the planner, change its walls only
+        through hierarchyToggleWall.
+        -clusterSize: Side of the clusters, between 2 and maxClusterSize.
+        -threadCount: Threads that build clusters, 0 uses one per processor.
+    Outputs:
+        -The planner, released with freeHierarchicalPlanner, or NULL if clusterSize is out of range.
+    */
+    if (clusterSize < 2 || clusterSize > maxClusterSize) // Slots of a cluster and entrance numbers are sized for it
+        return NULL;
+    HierarchicalPlanner *planner = calloc(1, sizeof(HierarchicalPlanner));
+    planner->matrix = matrix;
+    planner->rows = rows;
+    planner->columns = columns;
+    planner->clusterSize = clusterSize;
+    planner->clusterRows = (rows + clusterSize - 1) / clusterSize;
+    planner->clusterColumns = (columns + clusterSize - 1) / clusterSize;
+    planner->slotsPerCluster = 4 * clusterSize;
+    size_t clusters = (size_t) planner->clusterRows * planner->clusterColumns;
+    size_t nodes = clusters * planner->slotsPerCluster;
+    planner->slotEntrance = malloc(nodes);
+    planner->entranceCount = calloc(clusters, sizeof(int));
+    planner->entranceSlot = calloc(clusters, sizeof(unsigned short *));
+    planner->entranceDistance = calloc(clusters, sizeof(unsigned short *));
+    planner->cost = malloc(sizeof(int) * (nodes + 1)); // The goal is the node after the last slot
+    planner->parent = malloc(sizeof(int) * (nodes + 1));
+    planner->stamp = calloc(nodes + 1, sizeof(unsigned int));
+    planner->goalDistance = malloc(sizeof(unsigned short) * planner->slotsPerCluster);
+    createClusterScratch(&planner->scratch, clusterSize);
+
+    if (threadCount <= 0)
+        threadCount = threadsAvailable();
+    ClusterBuildJob job = {planner, 0};
+    pthread_t *threads = malloc(sizeof(pthread_t) * threadCount);
+    for (int thread = 1; thread < threadCount; thread++)
+        pthread_create(&threads[thread], NULL, clusterBuildThread, &job);
+    clusterBuildThread(&job);
+    for (int thread = 1; thread < threadCount; thread++)
+        pthread_join(threads[thread], NULL);
+    free(threads);
+    return planner;
+}
+
+void freeHierarchicalPlanner(HierarchicalPlanner *planner) {
+    int clusters = planner->clusterRows * planner->clusterColumns;
+    for (int cluster = 0; cluster < clusters; cluster++) {
+        free(planner->entranceSlot[cluster]);
+        free(planner->entranceDistance[cluster]);
+    }
+    free(planner->slotEntrance);
+    free(planner->entranceCount);
+    free(planner->entranceSlot);
+    free(planner->entranceDistance);
+    free(planner->cost);
+    free(planner->parent);
+    free(planner->stamp);
+    free(planner->goalDistance);
+    free(planner->abstractPath);
+    freeClusterScratch(&planner->scratch);
+    free(planner);
+}
+
+static inline void relaxNode(HierarchicalPlanner *planner, MinHeap *heap, int node, int cost, int parent, int heuristic) {
+    if (planner->stamp[node] != planner->query || cost < planner->cost[node]) {
+        planner->stamp[node] = planner->query;
+        planner->cost[node] = cost;
+        planner->parent[node] = parent;
+        heapPush(heap, (long long) cost + heuristic, node);
+    }
+}
+
+static inline int nodeHeuristic(const HierarchicalPlanner *planner, int node, int *x, int *y) {
+    /*
+    Subroutine that gives the cell of an entrance node and its Manhattan distance to the goal, which never
+    overestimates the moves left.
+    */
+    int cluster = node / planner->slotsPerCluster;
+    slotCell(planner, clusterBounds(planner, cluster), node % planner->slotsPerCluster, x, y);
+    return abs(*x - planner->goalX) + abs(*y - planner->goalY);
+}
+
+int hierarchyDistance(HierarchicalPlanner *planner, int startX, int startY, int goalX, int goalY) {
+    /*
+    Subroutine that finds the length of a shortest path between two cells with A* over the entrances, and keeps
+    the entrances of the path for hierarchyRefinePath.
+    Inputs and constraints:
+        -planner: The planner of the laberynth.
+        -startX, startY, goalX, goalY: Cells to join.
+    Outputs:
+        -The number of moves of the path, or -1 if the cells are not connected.
+    References:
+        -Hart, P. E., Nilsson, N. J., & Raphael, B. (1968). A formal basis for the heuristic determination of minimum
+        cost paths. IEEE Transactions on Systems Science and Cybernetics, 4(2), 100-107.
+    */
+    int slotsPerCluster = planner->slotsPerCluster;
+    int goalNode = planner->clusterRows * planner->clusterColumns * slotsPerCluster;
+    int startNode = -1;
+    planner->startX = startX;
+    planner->startY = startY;
+    planner->goalX = goalX;
+    planner->goalY = goalY;
+    planner->abstractPathSize = 0;
+    planner->pathFound = false;
+    if (++planner->query == 0) { // The stamps wrapped around
+        memset(planner->stamp, 0, sizeof(unsigned int) * (goalNode + 1));
+        planner->query = 1;
+    }
+
+    int startCluster = cellCluster(planner, startX, startY);
+    int goalCluster = cellCluster(planner, goalX, goalY);
+    ClusterBounds startBounds = clusterBounds(planner, startCluster);
+    ClusterBounds goalBounds = clusterBounds(planner, goalCluster);
+    MinHeap heap = {0};
+
+    // Goal joined to the entrances of its cluster, and straight to the start if both share the cluster
+    loadClusterOpenings(planner, goalBounds, &planner->scratch);
+    clusterBreadthFirst(goalBounds, goalX, goalY, &planner->scratch);
+    for (int entrance = 0; entrance < planner->entranceCount[goalCluster]; entrance++) {
+        int x, y;
+        slotCell(planner, goalBounds, planner->entranceSlot[goalCluster][entrance], &x, &y);
+        planner->goalDistance[entrance] = planner->scratch.distance[(x - goalBounds.top) * goalBounds.width + y - goalBounds.left];
+    }
+    if (startCluster == goalCluster) {
+        unsigned short direct = planner->scratch.distance[(startX - goalBounds.top) * goalBounds.width + startY - goalBounds.left];
+        if (direct != clusterUnreachable)
+            relaxNode(planner, &heap, goalNode, direct, startNode, 0);
+    }
+
+    // Start joined to the entrances of its cluster
+    loadClusterOpenings(planner, startBounds, &planner->scratch);
+    clusterBreadthFirst(startBounds, startX, startY, &planner->scratch);
+    for (int entrance = 0; entrance < planner->entranceCount[startCluster]; entrance++) {
+        int slot = planner->entranceSlot[startCluster][entrance];
+        int x, y;
+        slotCell(planner, startBounds, slot, &x, &y);
+        unsigned short distance = planner->scratch.distance[(x - startBounds.top) * startBounds.width + y - startBounds.left];
+        if (distance != clusterUnreachable)
+            relaxNode(planner, &heap, startCluster * slotsPerCluster + slot, distance, startNode, abs(x - goalX) + abs(y - goalY));
+    }
+
+    int result = -1;
+    while (heap.size > 0) {
+        HeapEntry entry = heapPop(&heap);
+        int node = entry.item;
+        if (node == goalNode) {
+            result = planner->cost[goalNode];
+            break;
+        }
+        int x, y;
+        int heuristic = nodeHeuristic(planner, node, &x, &y);
+        int cost = planner->cost[node];
+        if (entry.priority > (long long) cost + heuristic) // Stale entry
+            continue;
+
+        int cluster = node / slotsPerCluster;
+        int entrance = planner->slotEntrance[node];
+        int count = planner->entranceCount[cluster];
+        if (cluster == goalCluster && planner->goalDistance[entrance] != clusterUnreachable)
+            relaxNode(planner, &heap, goalNode, cost + planner->goalDistance[entrance], node, 0);
+        const unsigned short *distance = planner->entranceDistance[cluster] + entrance * count;
+        for (int other = 0; other < count; other++) {
+            if (other == entrance || distance[other] == clusterUnreachable)
+                continue;
+            int otherNode = cluster * slotsPerCluster + planner->entranceSlot[cluster][other];
+            int otherX, otherY;
+            int otherHeuristic = nodeHeuristic(planner, otherNode, &otherX, &otherY);
+            relaxNode(planner, &heap, otherNode, cost + distance[other], node, otherHeuristic);
+        }
+        int openings = insideOpenings(planner->matrix, planner->rows, planner->columns, x, y);
+        for (int direction = 0; direction < 4; direction++) {
+            int newX = x + directionRowStep[direction];
+            int newY = y + directionColumnStep[direction];
+            int newCluster = cellCluster(planner, newX, newY);
+            if (!(openings & directionOpening[direction]) || newCluster == cluster)
+                continue;
+            int newNode = newCluster * slotsPerCluster + borderSlot(planner, clusterBounds(planner, newCluster), newX, newY);
+            relaxNode(planner, &heap, newNode, cost + 1, node, abs(newX - goalX) + abs(newY - goalY));
+        }
+    }
+    freeHeap(&heap);
+
+    if (result >= 0) {
+        int size = 0;
+        for (int node = goalNode; node != startNode; node = planner->parent[node])
+            size++;
+        planner->abstractPath = realloc(planner->abstractPath, sizeof(int) * size);
+        planner->abstractPathSize = size;
+        for (int node = goalNode; node != startNode; node = planner->parent[node])
+            planner->abstractPath[--size] = node;
+        planner->pathFound = true;
+    }
+    return result;
+}
+
+int hierarchyRefinePath(HierarchicalPlanner *planner, int *pathX, int *pathY) {
+    /*
+    Subroutine that turns the path of the last hierarchyDistance into cells, searching inside the clusters between
+    consecutive entrances.
+    Inputs and constraints:
+        -planner: Planner whose last hierarchyDistance found a path (it did not return -1) with no wall changed
+        since.
+        -pathX, pathY: Arrays with room for every cell of the path (moves + 1).
+    Outputs:
+        -The number of cells written, from the start to the goal, or 0 (nothing written) without such a path.
+    */
+    if (!planner->pathFound)
+        return 0;
+    int goalNode = planner->clusterRows * planner->clusterColumns * planner->slotsPerCluster;
+    int x = planner->startX;
+    int y = planner->startY;
+    pathX[0] = x;
+    pathY[0] = y;
+    int size = 1;
+    for (int i = 0; i < planner->abstractPathSize; i++) {
+        int node = planner->abstractPath[i];
+        int targetX = planner->goalX;
+        int targetY = planner->goalY;
+        if (node != goalNode)
+            nodeHeuristic(planner, node, &targetX, &targetY);
+        int cluster = cellCluster(planner, x, y);
+        if (cluster != cellCluster(planner, targetX, targetY)) { // Through the opening between two clusters
+            x = targetX;
+            y = targetY;
+            pathX[size] = x;
+            pathY[size++] = y;
+            continue;
+        }
+        ClusterBounds bounds = clusterBounds(planner, cluster);
+        loadClusterOpenings(planner, bounds, &planner->scratch);
+        clusterBreadthFirst(bounds, targetX, targetY, &planner->scratch);
+        while (x != targetX || y != targetY) {
+            int back = planner->scratch.back[(x - bounds.top) * bounds.width + y - bounds.left];
+            x += directionRowStep[back];
+            y += directionColumnStep[back];
+            pathX[size] = x;
+            pathY[size++] = y;
+        }
+    }
+    return size;
+}
+
+void hierarchyToggleWall(HierarchicalPlanner *planner, int firstX, int firstY, int secondX, int secondY) {
+    /*
+    Subroutine that opens or closes the wall between two adjacent cells and rebuilds only the clusters of the
+    two cells.
+    */
+    int **matrix = planner->matrix;
+    int direction = secondX < firstX ? 0 : secondX > firstX ? 1 : secondY < firstY ? 2 : 3;
+    if (matrix[firstX][firstY] % 16 & directionOpening[direction])
+        addBarrierCell(matrix, firstX, firstY, secondX, secondY);
+    else
+        removeBarrierCell(matrix, firstX, firstY, secondX, secondY);
+    int firstCluster = cellCluster(planner, firstX, firstY);
+    int secondCluster = cellCluster(planner, secondX, secondY);
+    buildCluster(planner, firstCluster, &planner->scratch);
+    if (secondCluster != firstCluster)
+        buildCluster(planner, secondCluster, &planner->scratch);
+    planner->pathFound = false; // The path of the last query may go through the wall
+}
+
+void braidLaberynth(int **matrix, int rows, int columns, double fraction, unsigned long long seed) {
+    /*
+    Subroutine that adds loops to a laberynth by opening one more wall in a fraction of its dead ends.
+    Inputs and constraints:
+        -matrix, rows, columns: The laberynth.
+        -fraction: Fraction of the dead ends that are opened, between 0 and 1.
+        -seed: Seed of the choice of the dead ends and walls.
+    Outputs:
+        -The matrix with the new openings.
+    */
+    unsigned long long randomState = seedRandom(seed);
+    for (int x = 0; x < rows; x++) {
+        for (int y = 0; y < columns; y++) {
+            if (openingCount[insideOpenings(matrix, rows, columns, x, y)] != 1 || nextRandom(&randomState) >= fraction * 4294967296.0)
+                continue;
+            int closed[4];
+            int closedCount = 0;
+            for (int direction = 0; direction < 4; direction++) {
+                int newX = x + directionRowStep[direction];
+                int newY = y + directionColumnStep[direction];
+                if (newX >= 0 && newX < rows && newY >= 0 && newY < columns && !(matrix[x][y] % 16 & directionOpening[direction]))
+                    closed[closedCount++] = direction;
+            }
+            if (closedCount > 0) {
+                int direction = closed[nextRandom(&randomState) % closedCount];
+                removeBarrierCell(matrix, x, y, x + directionRowStep[direction], y + directionColumnStep[direction]);
+            }
+        }
+    }
+}
+
+void hierarchyDemo(int rows, int columns, int clusterSize, int queries, double braid) {
+    /*
+    Subroutine that builds the planner of a braided laberynth, times random queries and a wall change, and checks
+    the entrance to exit distance with the distance field.
+    */
+    int **matrix = createMatrix(rows, columns);
+    CellLayout layout = createCellLayout(rowMajorLayout, rows, columns);
+    generateLaberynthCells(matrix[0], &layout, 1);
+    braidLaberynth(matrix, rows, columns, braid, 1);
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    HierarchicalPlanner *planner = createHierarchicalPlanner(matrix, rows, columns, clusterSize, 0);
+    double buildSeconds = elapsedSeconds(start);
+    if (planner == NULL) {
+        printf("The cluster size must be between 2 and %d\n", maxClusterSize);
+        freeMatrix(matrix, rows);
+        return;
+    }
+
+    unsigned long long randomState = seedRandom(2);
+    long long totalMoves = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int query = 0; query < queries; query++) {
+        int startX = nextRandom(&randomState) % rows, startY = nextRandom(&randomState) % columns;
+        int goalX = nextRandom(&randomState) % rows, goalY = nextRandom(&randomState) % columns;
+        totalMoves += hierarchyDistance(planner, startX, startY, goalX, goalY);
+    }
+    double querySeconds = elapsedSeconds(start) / (queries > 0 ? queries : 1);
+
+    int moves = hierarchyDistance(planner, 0, 0, rows - 1, columns - 1);
+    int cells = 0;
+    if (moves >= 0) {
+        int *pathX = malloc(sizeof(int) * (moves + 1));
+        int *pathY = malloc(sizeof(int) * (moves + 1));
+        cells = hierarchyRefinePath(planner, pathX, pathY);
+        free(pathX);
+        free(pathY);
+    }
+    unsigned int *distance = computeDistanceField(matrix, rows, columns, 0);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    hierarchyToggleWall(planner, rows / 2, columns / 2, rows / 2, columns / 2 + 1);
+    double toggleSeconds = elapsedSeconds(start);
+
+    printf("Clusters: %d x %d, build: %.3f s\n", planner->clusterRows, planner->clusterColumns, buildSeconds);
+    printf("Random queries: %.6f s each, %lld moves on average\n", querySeconds, queries > 0 ? totalMoves / queries : 0);
+    printf("Entrance to exit: %d moves (distance field %u), %d cells\n", moves, distance[0], cells);
+    printf("Wall change: %.6f s\n", toggleSeconds);
+
+    releaseLargeBlock(distance);
+    freeHierarchicalPlanner(planner);
+    freeMatrix(matrix, rows);
+}
+
+/*******************************Generation Checkpoints*******************************/
+/*
+A long generation saves its state so it can be resumed after a crash with exactly the same result.
+// path ; Base file: CheckpointHeader in the first page, then the cells, the frontier X and the frontier Y values
+// path.journal ; Records appended after the base: JournalRecordHeader, list of blocks, values of the blocks
+A checkpoint appends one record with the blocks marked dirty since the previous checkpoint and the generator state,
+and waits for it to reach the disk with fdatasync. When the journal grows past half of the base, the blocks
+changed since the last compaction are copied into the mapped base, the base is written with msync and only then
+its header, and the journal is emptied. Resuming loads the base and replays the records after it in order, up to
+the first torn or corrupt record; a crash in the middle of a compaction is safe because the journal still holds
+every block copied.
+The base is not a binary grid file (BinaryGridHeader, "LABY") because it holds what that format can not: a
+laberynth being built, whose cells are in the order of any CellLayout and still have the -1 of the frontier and
+the starter value of the initial cell, 32 bits each, the two frontier arrays and the generator state. It is also
+rewritten in place, so its header must sit alone in the first page and be written after the cells it describes,
+while a binary grid puts the payload right after its 32 byte header. The finished laberynth is saved as a binary
+grid file (checkpoint mode of main), and the checkpoint files are removed once the generation finishes.
+*/
+
+#define checkpointVersion 1
+#define checkpointHeaderBytes 4096
+#define journalRecordMagic 0x4C4A524Eu // "NRJL"
+
+typedef struct {
+    char magic[4];             // "LABC"
+    unsigned int version;
+    unsigned int rows;
+    unsigned int columns;
+    int layoutKind;
+    unsigned int reserved;
+    unsigned long long seed;
+    unsigned long long sequence;  // Last record copied into the base, 0 for an empty base
+    GeneratorState state;
+    unsigned long long checksum;  // Of everything above
+} CheckpointHeader;
+
+typedef struct {
+    unsigned int magic;
+    unsigned int blockCount;
+    unsigned long long sequence;
+    GeneratorState state;
+    unsigned long long checksum;  // Of sequence, state, list of blocks and values
+} JournalRecordHeader;
+
+typedef struct {
+    unsigned int region;
+    unsigned int block;
+} JournalBlock;
+
+typedef struct {
+    LaberynthGenerator *generator;
+    char *basePath;
+    char *journalPath;
+    int journal;
+    unsigned char *base;          // Mapping of the base file
+    size_t baseBytes;
+    size_t regionOffset[generatorRegions];
+    unsigned long long sequence;  // Last record written
+    size_t journalBytes;
+    unsigned char *pending[2];    // Blocks in the journal but not in the base
+    unsigned char *buffer;        // Records are written in pieces of checkpointBufferBytes
+    size_t bufferUsed;
+    bool failed;
+} GenerationCheckpoint;
+
+#define checkpointBufferBytes (4 << 20)
+#define checkpointOverhead 0.03 // Largest fraction of the time spent in checkpoints
+
+unsigned long long checksumBytes(unsigned long long hash, const void *data, size_t bytes) {
+    /*
+    Subroutine that adds bytes to a running 64 bit checksum, eight bytes at a time.
+    */
+    const unsigned char *pointer = data;
+    while (bytes >= 8) {
+        unsigned long long word;
+        memcpy(&word, pointer, 8);
+        hash = (hash ^ word) * 0x100000001B3ULL;
+        hash ^= hash >> 29;
+        pointer += 8;
+        bytes -= 8;
+    }
+    while (bytes-- > 0)
+        hash = (hash ^ *pointer++) * 0x100000001B3ULL;
+    return hash;
+}
+
+static inline size_t blockValues(const LaberynthGenerator *generator, int region, size_t block) {
+    size_t first = block << generatorBlockShift;
+    size_t last = first + generatorBlockSize < generator->regionSize[region] ? first + generatorBlockSize : generator->regionSize[region];
+    return last - first;
+}
+
+static inline unsigned char *regionDirty(unsigned char **dirty, int region) {
+    return dirty[region == 0 ? 0 : 1];
+}
+
+bool flushCheckpointBuffer(GenerationCheckpoint *checkpoint) {
+    if (!checkpoint->failed && !writeAll(checkpoint->journal, checkpoint->buffer, checkpoint->bufferUsed))
+        checkpoint->failed = true;
+    checkpoint->journalBytes += checkpoint->bufferUsed;
+    checkpoint->bufferUsed = 0;
+    return !checkpoint->failed;
+}
+
+void appendCheckpointBytes(GenerationCheckpoint *checkpoint, const void *data, size_t bytes) {
+    const unsigned char *pointer = data;
+    while (bytes > 0) {
+        size_t piece = checkpointBufferBytes - checkpoint->bufferUsed < bytes ? checkpointBufferBytes - checkpoint->bufferUsed : bytes;
+        memcpy(checkpoint->buffer + checkpoint->bufferUsed, pointer, piece);
+        checkpoint->bufferUsed += piece;
+        pointer += piece;
+        bytes -= piece;
+        if (checkpoint->bufferUsed == checkpointBufferBytes)
+            flushCheckpointBuffer(checkpoint);
+    }
+}
+
+unsigned long long headerChecksum(const CheckpointHeader *header) {
+    return checksumBytes(0xCBF29CE484222325ULL, header, offsetof(CheckpointHeader, checksum));
+}
+
+bool compactCheckpoint(GenerationCheckpoint *checkpoint) {
+    /*
+    Subroutine that copies the blocks of the journal into the base, then the header, and empties the journal.
+    */
+    LaberynthGenerator *generator = checkpoint->generator;
+    for (int region = 0; region < generatorRegions; region++) {
+        unsigned char *pending = regionDirty(checkpoint->pending, region);
+        size_t blocks = (generator->regionSize[region] >> generatorBlockShift) + 1;
+        for (size_t block = 0; block < blocks; block++) {
+            if (pending[block])
+                memcpy(checkpoint->base + checkpoint->regionOffset[region] + (block << generatorBlockShift) * sizeof(int),
+                       generator->region[region] + (block << generatorBlockShift), blockValues(generator, region, block) * sizeof(int));
+        }
+    }
+    if (msync(checkpoint->base, checkpoint->baseBytes, MS_SYNC) != 0)
+        return false;
+
+    CheckpointHeader *header = (CheckpointHeader *) checkpoint->base;
+    header->sequence = checkpoint->sequence;
+    header->state = generator->state;
+    header->checksum = headerChecksum(header);
+    if (msync(checkpoint->base, checkpointHeaderBytes, MS_SYNC) != 0 || ftruncate(checkpoint->journal, 0) != 0 || fdatasync(checkpoint->journal) != 0)
+        return false;
+    checkpoint->journalBytes = 0;
+    for (int region = 0; region < 2; region++)
+        memset(checkpoint->pending[region], 0, (generator->regionSize[region] >> generatorBlockShift) + 1);
+    return true;
+}
+
+bool writeGenerationCheckpoint(GenerationCheckpoint *checkpoint) {
+    /*
+    Subroutine that saves the state of the generator: appends a record with the dirty blocks, waits for it to be
+    on disk and compacts the journal when it is too big.
+    Inputs and constraints:
+        -checkpoint: Checkpoint of the generator.
+    Outputs:
+        -true if the checkpoint is on disk, the generator can go on in any case.
+    */
+    LaberynthGenerator *generator = checkpoint->generator;
+    JournalRecordHeader header;
+    header.magic = journalRecordMagic;
+    header.blockCount = 0;
+    header.sequence = checkpoint->sequence + 1;
+    header.state = generator->state;
+    for (int region = 0; region < generatorRegions; region++) {
+        unsigned char *dirty = regionDirty(generator->dirty, region);
+        for (size_t block = 0; block <= generator->regionSize[region] >> generatorBlockShift; block++)
+            header.blockCount += dirty[block];
+    }
+
+    // Checksum first, then the record
+    unsigned long long checksum = checksumBytes(0xCBF29CE484222325ULL, &header.sequence, sizeof(header.sequence) + sizeof(header.state));
+    for (int pass = 0; pass < 2; pass++) {
+        for (int region = 0; region < generatorRegions; region++) {
+            unsigned char *dirty = regionDirty(generator->dirty, region);
+            for (size_t block = 0; block <= generator->regionSize[region] >> generatorBlockShift; block++) {
+                if (!dirty[block])
+                    continue;
+                JournalBlock entry = {region, (unsigned int) block};
+                if (pass == 0)
+                    checksum = checksumBytes(checksum, &entry, sizeof(entry));
+                else
+                    appendCheckpointBytes(checkpoint, &entry, sizeof(entry));
+            }
+        }
+        for (int region = 0; region < generatorRegions; region++) {
+            unsigned char *dirty = regionDirty(generator->dirty, region);
+            for (size_t block = 0; block <= generator->regionSize[region] >> generatorBlockShift; block++) {
+                if (!dirty[block])
+                    continue;
+                const int *values = generator->region[region] + (block << generatorBlockShift);
+                size_t bytes = blockValues(generator, region, block) * sizeof(int);
+                if (pass == 0)
+                    checksum = checksumBytes(checksum, values, bytes);
+                else
+                    appendCheckpointBytes(checkpoint, values, bytes);
+            }
+        }
+        if (pass == 0) {
+            header.checksum = checksum;
+            appendCheckpointBytes(checkpoint, &header, sizeof(header));
+        }
+    }
+    if (!flushCheckpointBuffer(checkpoint) || fdatasync(checkpoint->journal) != 0) {
+        checkpoint->failed = true;
+        return false;
+    }
+
+    checkpoint->sequence++;
+    for (int region = 0; region < 2; region++) {
+        size_t blocks = (generator->regionSize[region] >> generatorBlockShift) + 1;
+        for (size_t block = 0; block < blocks; block++)
+            checkpoint->pending[region][block] |= generator->dirty[region][block];
+        memset(generator->dirty[region], 0, blocks);
+    }
+    if (checkpoint->journalBytes > checkpoint->baseBytes / 2 && !compactCheckpoint(checkpoint)) {
+        checkpoint->failed = true;
+        return false;
+    }
+    return true;
+}
+
+bool replayJournal(GenerationCheckpoint *checkpoint, bool *loaded) {
+    /*
+    Subroutine that applies the records of the journal written after the base, stopping at the first incomplete
+    or corrupt record, and cuts the journal after the last good one.
+    Outputs:
+        -false if the journal cannot be read or cut. loaded tells whether at least one record was applied.
+    */
+    LaberynthGenerator *generator = checkpoint->generator;
+    struct stat information;
+    *loaded = false;
+    if (fstat(checkpoint->journal, &information) != 0)
+        return false;
+    size_t journalBytes = information.st_size;
+    unsigned char *journal = journalBytes > 0 ? mmap(NULL, journalBytes, PROT_READ, MAP_PRIVATE, checkpoint->journal, 0) : NULL;
+    if (journal == MAP_FAILED)
+        return false;
+
+    size_t offset = 0;
+    while (offset + sizeof(JournalRecordHeader) <= journalBytes) {
+        JournalRecordHeader header;
+        memcpy(&header, journal + offset, sizeof(header));
+        if (header.magic != journalRecordMagic || header.sequence != checkpoint->sequence + 1)
+            break;
+        const JournalBlock *entries = (const JournalBlock *) (journal + offset + sizeof(header));
+        size_t listBytes = sizeof(JournalBlock) * (size_t) header.blockCount;
+        size_t recordBytes = sizeof(header) + listBytes;
+        if (offset + recordBytes > journalBytes)
+            break;
+        bool valid = true;
+        for (unsigned int i = 0; i < header.blockCount && valid; i++) {
+            valid = entries[i].region < generatorRegions && entries[i].block <= generator->regionSize[entries[i].region] >> generatorBlockShift;
+            if (valid)
+                recordBytes += blockValues(generator, entries[i].region, entries[i].block) * sizeof(int);
+        }
+        if (!valid || offset + recordBytes > journalBytes)
+            break;
+        const unsigned char *values = (const unsigned char *) entries + listBytes;
+        unsigned long long checksum = checksumBytes(0xCBF29CE484222325ULL, &header.sequence, sizeof(header.sequence) + sizeof(header.state));
+        checksum = checksumBytes(checksum, entries, listBytes);
+        checksum = checksumBytes(checksum, values, recordBytes - sizeof(header) - listBytes);
+        if (checksum != header.checksum)
+            break;
+
+        for (unsigned int i = 0; i < header.blockCount; i++) {
+            size_t bytes = blockValues(generator, entries[i].region, entries[i].block) * sizeof(int);
+            memcpy(generator->region[entries[i].region] + ((size_t) entries[i].block << generatorBlockShift), values, bytes);
+            regionDirty(checkpoint->pending, entries[i].region)[entries[i].block] = 1;
+            values += bytes;
+        }
+        generator->state = header.state;
+        checkpoint->sequence = header.sequence;
+        offset += recordBytes;
+        *loaded = true;
+    }
+    if (journal != NULL)
+        munmap(journal, journalBytes);
+    checkpoint->journalBytes = offset;
+    return ftruncate(checkpoint->journal, offset) == 0;
+}
+
+void freeGenerationCheckpoint(GenerationCheckpoint *checkpoint) {
+    if (checkpoint->base != NULL && checkpoint->base != MAP_FAILED)
+        munmap(checkpoint->base, checkpoint->baseBytes);
+    if (checkpoint->journal >= 0)
+        close(checkpoint->journal);
+    free(checkpoint->buffer);
+    free(checkpoint->pending[0]);
+    free(checkpoint->pending[1]);
+    free(checkpoint->basePath);
+    free(checkpoint->journalPath);
+    free(checkpoint);
+}
+
+GenerationCheckpoint *openGenerationCheckpoint(const char *path, LaberynthGenerator *generator, bool *resumed) {
+    /*
+    Subroutine that resumes a generator from its checkpoint files, or starts new files if there is no usable
+    checkpoint for the same size, layout and seed.
+    Inputs and constraints:
+        -path: Base file, the journal is path.journal.
+        -generator: Generator just created with createLaberynthGenerator, its state is replaced when resuming.
+        -resumed: Pointer where it is stored whether the state came from the files.
+    Outputs:
+        -The checkpoint, closed with closeGenerationCheckpoint, or NULL if the files cannot be used.
+    */
+    GenerationCheckpoint *checkpoint = calloc(1, sizeof(GenerationCheckpoint));
+    checkpoint->generator = generator;
+    checkpoint->basePath = strdup(path);
+    checkpoint->journalPath = malloc(strlen(path) + 9);
+    sprintf(checkpoint->journalPath, "%s.journal", path);
+    checkpoint->regionOffset[0] = checkpointHeaderBytes;
+    for (int region = 1; region < generatorRegions; region++)
+        checkpoint->regionOffset[region] = checkpoint->regionOffset[region - 1] + generator->regionSize[region - 1] * sizeof(int);
+    checkpoint->baseBytes = checkpoint->regionOffset[generatorRegions - 1] + generator->regionSize[generatorRegions - 1] * sizeof(int);
+    for (int region = 0; region < 2; region++)
+        checkpoint->pending[region] = calloc((generator->regionSize[region] >> generatorBlockShift) + 1, 1);
+    checkpoint->buffer = malloc(checkpointBufferBytes);
+    *resumed = false;
+
+    CheckpointHeader expected;
+    memset(&expected, 0, sizeof(expected));
+    memcpy(expected.magic, "LABC", 4);
+    expected.version = checkpointVersion;
+    expected.rows = generator->layout.rows;
+    expected.columns = generator->layout.columns;
+    expected.layoutKind = generator->layout.kind;
+    expected.seed = generator->seed;
+
+    int base = open(path, O_RDWR | O_CREAT, 0644);
+    checkpoint->journal = open(checkpoint->journalPath, O_RDWR | O_CREAT | O_APPEND, 0644);
+    struct stat information;
+    CheckpointHeader header;
+    if (base < 0 || checkpoint->journal < 0 || fstat(base, &information) != 0) {
+        if (base >= 0)
+            close(base);
+        freeGenerationCheckpoint(checkpoint);
+        return NULL;
+    }
+    bool usable = (size_t) information.st_size == checkpoint->baseBytes && pread(base, &header, sizeof(header), 0) == (ssize_t) sizeof(header)
+        && memcmp(&header, &expected, offsetof(CheckpointHeader, sequence)) == 0 && header.checksum == headerChecksum(&header);
+    if (!usable) { // Base of another laberynth or never finished, start again from zeros
+        expected.state = generator->state;
+        expected.checksum = headerChecksum(&expected);
+        if (ftruncate(base, 0) != 0 || ftruncate(base, checkpoint->baseBytes) != 0 || pwrite(base, &expected, sizeof(expected), 0) != (ssize_t) sizeof(expected)
+            || fdatasync(base) != 0 || ftruncate(checkpoint->journal, 0) != 0) {
+            close(base);
+            freeGenerationCheckpoint(checkpoint);
+            return NULL;
+        }
+    }
+    checkpoint->base = mmap(NULL, checkpoint->baseBytes, PROT_READ | PROT_WRITE, MAP_SHARED, base, 0);
+    close(base);
+    if (checkpoint->base == MAP_FAILED) {
+        freeGenerationCheckpoint(checkpoint);
+        return NULL;
+    }
+    if (!usable)
+        return checkpoint;
+
+    checkpoint->sequence = header.sequence;
+    if (header.sequence > 0) {
+        for (int region = 0; region < generatorRegions; region++)
+            memcpy(generator->region[region], checkpoint->base + checkpoint->regionOffset[region], generator->regionSize[region] * sizeof(int));
+        generator->state = header.state;
+    }
+    bool loaded;
+    if (!replayJournal(checkpoint, &loaded)) {
+        freeGenerationCheckpoint(checkpoint);
+        return NULL;
+    }
+    *resumed = header.sequence > 0 || loaded;
+    if (*resumed) { // Everything loaded is already in the files
+        for (int region = 0; region < 2; region++)
+            memset(generator->dirty[region], 0, (generator->regionSize[region] >> generatorBlockShift) + 1);
+    }
+    return checkpoint;
+}
+
+void closeGenerationCheckpoint(GenerationCheckpoint *checkpoint, bool removeFiles) {
+    /*
+    Subroutine that closes the checkpoint files, removing them once the laberynth is finished.
+    */
+    if (removeFiles) {
+        unlink(checkpoint->basePath);
+        unlink(checkpoint->journalPath);
+    }
+    freeGenerationCheckpoint(checkpoint);
+}
+
+bool generateLaberynthCheckpointed(int *cells, const CellLayout *layout, unsigned long long seed, const char *path, long long checkpointCells,
+                                   long long stopAfterCheckpoints, bool *checkpointFailed) {
+    /*
+    Subroutine that generates a laberynth like generateLaberynthCells saving checkpoints, and resumes from the
+    checkpoint of an interrupted run of the same size, layout and seed. The result is the same as
+    generateLaberynthCells. The cells between checkpoints grow when a checkpoint takes more than
+    checkpointOverhead of the time spent generating.
+    Inputs and constraints:
+        -cells, layout, seed: As in generateLaberynthCells.
+        -path: Base file of the checkpoint, the files are removed when the laberynth is finished.
+        -checkpointCells: Minimum number of cells added between checkpoints.
+        -stopAfterCheckpoints: Stops after this many checkpoints leaving the files, as a crash would, 0 never stops.
+        -checkpointFailed: Pointer where true is stored if a checkpoint could not be written (full disk, I/O error),
+        in that case the generation stops and can be resumed from the last checkpoint on disk. It can be NULL.
+    Outputs:
+        -true if the laberynth is finished.
+    */
+    if (checkpointFailed != NULL)
+        *checkpointFailed = false;
+    LaberynthGenerator *generator = createLaberynthGenerator(cells, layout, seed);
+    if (generator == NULL)
+        return false;
+    bool resumed;
+    GenerationCheckpoint *checkpoint = openGenerationCheckpoint(path, generator, &resumed);
+    if (checkpoint == NULL) {
+        if (checkpointFailed != NULL)
+            *checkpointFailed = true;
+        freeLaberynthGenerator(generator);
+        return false;
+    }
+    if (resumed)
+        printf("Resumed from checkpoint %llu, %llu cells added\n", checkpoint->sequence, generator->state.addedCells);
+
+    long long checkpoints = 0;
+    long long interval = checkpointCells;
+    bool finished;
+    while (true) {
+        struct timespec start;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        if ((finished = stepLaberynthGenerator(generator, interval)))
+            break;
+        double stepSeconds = elapsedSeconds(start);
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        if (!writeGenerationCheckpoint(checkpoint)) { // Going on would run without crash protection
+            if (checkpointFailed != NULL)
+                *checkpointFailed = true;
+            finished = false;
+            break;
+        }
+        double checkpointSeconds = elapsedSeconds(start);
+        if (checkpointSeconds > checkpointOverhead * stepSeconds)
+            interval = (long long) (interval * checkpointSeconds / (checkpointOverhead * stepSeconds)) + 1;
+        if (++checkpoints == stopAfterCheckpoints)
+            break;
+    }
+    closeGenerationCheckpoint(checkpoint, finished);
+    freeLaberynthGenerator(generator);
+    return finished;
+}
+
+long long interleavedRandomWalks(int **matrix, int rows, int columns, int walkers, long long steps, unsigned long long seed) {
+    /*
+    Subroutine that moves several random mice at once, one move of each in turn, without marks. Every move of the
+    loop lands far from the previous one, as when many solves share the laberynth, which stresses the TLB.
+    Outputs:
+        -Sum of the final positions, so the walks are not optimized away.
+    */
+    unsigned long long randomState = seedRandom(seed);
+    int *positionX = malloc(sizeof(int) * walkers);
+    int *positionY = malloc(sizeof(int) * walkers);
+    for (int walker = 0; walker < walkers; walker++) {
+        positionX[walker] = nextRandom(&randomState) % rows;
+        positionY[walker] = nextRandom(&randomState) % columns;
+    }
+    for (long long step = 0; step < steps; step++) {
+        int walker = step % walkers;
+        int openings = insideOpenings(matrix, rows, columns, positionX[walker], positionY[walker]);
+        if (openings == 0)
+            continue;
+        int direction;
+        do {
+            direction = nextRandom(&randomState) % 4;
+        } while (!(openings & directionOpening[direction]));
+        positionX[walker] += directionRowStep[direction];
+        positionY[walker] += directionColumnStep[direction];
+    }
+    long long sum = 0;
+    for (int walker = 0; walker < walkers; walker++)
+        sum += (long long) positionX[walker] * columns + positionY[walker];
+    free(positionX);
+    free(positionY);
+    return sum;
+}
+
+void benchmarkAllocations(int rows, int columns, long long steps, int touchThreads) {
+    /*
+    Subroutine that compares the allocations of the cells of a laberynth: normal, transparent and explicit huge
+    pages, touched first by the calling thread or by touchThreads threads pinned to the NUMA nodes. For each one
+    it prints the pages obtained, the time to allocate and generate, and the moves per second and dTLB misses per
+    move of interleaved random mice.
+    */
+    const char *pageNames[] = {"normal", "transparent", "explicit"};
+    int tlbMisses = openPerfCounter(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                                    | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+    printf("NUMA nodes: %d\n", numaNodes());
+    printf("%-12s %-12s %-10s %12s %12s %14s %14s\n", "pages", "obtained", "touch", "allocate s", "generate s", "moves/s", "dTLB miss/move");
+    for (int pages = normalPages; pages <= explicitHugePages; pages++) {
+        for (int touch = 0; touch < 2; touch++) {
+            AllocationOptions options = {pages, touch ? touchThreads : 0};
+            char touchName[16];
+            snprintf(touchName, sizeof(touchName), touch ? "%d threads" : "caller", touchThreads);
+            struct timespec start;
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            int **matrix = createMatrixWithOptions(rows, columns, &options);
+            double allocateSeconds = elapsedSeconds(start);
+            if (matrix == NULL) {
+                printf("%-12s %-12s %-10s no memory\n", pageNames[pages], "-", touchName);
+                continue;
+            }
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            CellLayout layout = createCellLayout(rowMajorLayout, rows, columns);
+            generateLaberynthCells(matrix[0], &layout, 1);
+            double generateSeconds = elapsedSeconds(start);
+
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            startPerfCounter(tlbMisses);
+            volatile long long checksum = interleavedRandomWalks(matrix, rows, columns, 256, steps, 1);
+            (void) checksum;
+            long long misses = stopPerfCounter(tlbMisses);
+            double walkSeconds = elapsedSeconds(start);
+
+            char missesName[32] = "n/a"; // Without perf events
+            if (misses >= 0)
+                snprintf(missesName, sizeof(missesName), "%.3f", (double) misses / steps);
+            printf("%-12s %-12s %-10s %12.3f %12.3f %14.0f %14s\n", pageNames[pages], pageNames[largeBlockPages(matrix[0])], touchName,
+                   allocateSeconds, generateSeconds, steps / walkSeconds, missesName);
+            freeMatrix(matrix, rows);
+        }
+    }
+    if (tlbMisses >= 0)
+        close(tlbMisses);
+}
+
+/*******************************Padded Kernels*******************************/
+/*
+Specialized generator and solvers without bounds checks on rows and columns. The cells are stored row after row
+inside a border of sentinel cells: a full row above and a full row below. Two layouts:
+// Power of two widths ; stride = columns = 2^k, the column of a cell is index & (columns - 1) and its row index >> k,
+//                       the generator tests the column with the mask before a move to the left or to the right
+// Other widths ; stride = columns + 1, the extra column of every row is a sentinel that is also the cell on the left
+//                of the next row, so no test at all
+The generator never takes a sentinel as a frontier or tree cell, and the cells only keep the openings to other cells
+(the entrance and exit openings are added back by unpadLaberynth), so a solver move never leaves the grid and every
+neighbor is index + step.
+The kernels are always inlined into dispatchers that call them with constants for the power of two widths from 16
+to 4096 and for the fixed sizes of the sweeps (fixedPaddedSizes), so the steps, the mask and the loop bounds are
+immediates, and with the values of the laberynth for the rest (paddedStrideKernel). The results are the same as
+generateLaberynthCells, randomMouseCells and tremauxCells with the same seeds, for every kernel.
+Nearly all the gain comes from the sentinel padding, not from the constants: with the kernels mode the padded
+runtime stride kernels are about 1.5-1.8x faster than the generic functions to generate, 1.1x for the random mouse
+and 1.2-1.4x for Tremaux, while the constant stride kernels only add 1.00-1.05x over them (the loops wait on loads
+and random numbers, not on the multiply of the index). The constant versions are kept so the kernels mode can
+measure that difference on every width.
+*/
+
+#define paddedSentinel -2
+
+#define paddedStrideKernel 0 // Stride and size read at runtime
+#define paddedShiftKernel  1 // Power of two width, constant shift and mask
+#define paddedFixedKernel  2 // Constant size of fixedPaddedSizes
+
+const int fixedPaddedSizes[] = {5, 10, 20, 50, 100}; // Square laberynths of the sweeps
+const char *paddedKernelNames[] = {"runtime stride", "power of two", "fixed size"};
+
+typedef struct {
+    int rows;
+    int columns;
+    int stride;
+    bool sentinelColumn; // false for the power of two widths
+    int kernel;          // Specialization used by the dispatchers
+    size_t size;         // (rows + 2) * stride
+    int *cells;          // Including the sentinels
+    int *origin;         // Cell (0, 0), cell (x, y) is origin[x * stride + y]
+} PaddedLaberynth;
+
+PaddedLaberynth *createPaddedLaberynth(int rows, int columns) {
+    /*
+    Subroutine that allocates a padded laberynth and chooses its kernel.
+    */
+    PaddedLaberynth *padded = malloc(sizeof(PaddedLaberynth));
+    padded->rows = rows;
+    padded->columns = columns;
+    padded->sentinelColumn = columns < 16 || columns > 4096 || (columns & (columns - 1)) != 0;
+    padded->stride = padded->sentinelColumn ? columns + 1 : columns;
+    padded->kernel = padded->sentinelColumn ? paddedStrideKernel : paddedShiftKernel;
+    for (size_t size = 0; size < sizeof(fixedPaddedSizes) / sizeof(fixedPaddedSizes[0]); size++) {
+        if (rows == fixedPaddedSizes[size] && columns == fixedPaddedSizes[size])
+            padded->kernel = paddedFixedKernel;
+    }
+    padded->size = (size_t) (rows + 2) * padded->stride;
+    padded->cells = malloc(sizeof(int) * padded->size);
+    padded->origin = padded->cells + padded->stride;
+    return padded;
+}
+
+void freePaddedLaberynth(PaddedLaberynth *padded) {
+    free(padded->cells);
+    free(padded);
+}
+
+void padLaberynth(PaddedLaberynth *padded, int **matrix) {
+    /*
+    Subroutine that copies a laberynth into a padded one, without the entrance and exit openings.
+    */
+    for (size_t index = 0; index < padded->size; index++)
+        padded->cells[index] = paddedSentinel;
+    for (int x = 0; x < padded->rows; x++)
+        memcpy(padded->origin + (size_t) x * padded->stride, matrix[x], sizeof(int) * padded->columns);
+    padded->origin[0] -= aboveOpening;
+    padded->origin[(size_t) (padded->rows - 1) * padded->stride + padded->columns - 1] -= belowOpening;
+}
+
+void unpadLaberynth(const PaddedLaberynth *padded, int **matrix) {
+    /*
+    Subroutine that copies a padded laberynth into a matrix, adding the entrance and exit openings (step five).
+    */
+    for (int x = 0; x < padded->rows; x++)
+        memcpy(matrix[x], padded->origin + (size_t) x * padded->stride, sizeof(int) * padded->columns);
+    matrix[0][0] += aboveOpening;
+    matrix[padded->rows - 1][padded->columns - 1] += belowOpening;
+}
+
+static inline __attribute__((always_inline)) bool paddedMoveInside(long long position, int direction, int columns, bool sentinelColumn) {
+    /*
+    Subroutine that tells if a move stays in the row of the cell, only tested without the sentinel column, where
+    columns is a power of two.
+    */
+    if (sentinelColumn || direction < 2)
+        return true;
+    int column = (int) (position & (columns - 1));
+    return direction == 2 ? column != 0 : column != columns - 1;
+}
+
+static inline __attribute__((always_inline)) void generatePaddedKernel(int *cells, int *origin, size_t size, int rows, int columns, int stride,
+                                                                         bool sentinelColumn, unsigned long long seed) {
+    /*
+    Subroutine that is the loop of generateLaberynthCells on a padded laberynth: the same choices with the same
+    seed, with the frontier cells kept as indexes from the origin.
+    */
+    const int step[4] = {-stride, stride, -1, 1};
+    unsigned long long randomState = seedRandom(seed);
+    for (size_t index = 0; index < size; index++)
+        cells[index] = paddedSentinel;
+    for (int x = 0; x < rows; x++)
+        memset(origin + (size_t) x * stride, 0, sizeof(int) * columns);
+    size_t *frontierCells = malloc(sizeof(size_t) * (size_t) rows * columns); // Indexes pass 2^31 in the largest laberynths
+    size_t frontierCellsArraySize = 0;
+
+    // Step one
+    int positionX = nextRandom(&randomState) % rows;
+    int positionY = nextRandom(&randomState) % columns;
+    long long initial = (long long) positionX * stride + positionY;
+    long long position = initial;
+    origin[position] = initialCellStarterValue;
+
+    while (true) {
+        for (int direction = 0; direction < 4; direction++) {
+            long long neighbor = position + step[direction];
+            if (paddedMoveInside(position, direction, columns, sentinelColumn) && origin[neighbor] == 0) { // Sentinels are never 0
+                origin[neighbor] = -1;
+                frontierCells[frontierCellsArraySize++] = (size_t) neighbor;
+            }
+        }
+        if (frontierCellsArraySize == 0)
+            break;
+
+        size_t randomPosition = nextRandom(&randomState) % frontierCellsArraySize;
+        position = frontierCells[randomPosition];
+        frontierCells[randomPosition] = frontierCells[--frontierCellsArraySize];
+
+        int treeDirections[4];
+        int treeDirectionsSize = 0;
+        for (int direction = 0; direction < 4; direction++) {
+            treeDirections[treeDirectionsSize] = direction;
+            treeDirectionsSize += paddedMoveInside(position, direction, columns, sentinelColumn) && origin[position + step[direction]] > 0; // Nor positive
+        }
+        int direction = treeDirections[nextRandom(&randomState) % treeDirectionsSize];
+        origin[position] = directionOpening[direction];
+        origin[position + step[direction]] += directionOppositeOpening[direction];
+    }
+    origin[initial] -= initialCellStarterValue;
+    free(frontierCells);
+}
+
+static inline __attribute__((always_inline)) long long randomMousePaddedKernel(int *origin, long long exit, int stride, long long maxCycles,
+                                                                                 unsigned long long seed) {
+    /*
+    Subroutine that is the loop of randomMouseCells on a padded laberynth.
+    */
+    const int step[4] = {-stride, stride, -1, 1};
+    unsigned long long randomState = seedRandom(seed);
+    long long current = 0;
+    long long totalCycles = 0;
+    origin[current] += 16;
+    while (current != exit && totalCycles < maxCycles) {
+        int value = origin[current] & 15;
+        int direction;
+        do {
+            direction = nextRandom(&randomState) % 4;
+        } while (!(value & directionOpening[direction]));
+        long long next = current + step[direction];
+        if (origin[next] > 15)
+            origin[current] -= 16;
+        else
+            origin[next] += 16;
+        current = next;
+        totalCycles++;
+    }
+    return totalCycles;
+}
+
+static inline __attribute__((always_inline)) long long tremauxPaddedKernel(int *origin, long long exit, int stride, long long maxCycles) {
+    /*
+    Subroutine that is the loop of tremauxCells on a padded laberynth.
+    */
+    const int step[4] = {-stride, stride, -1, 1};
+    long long current = 0;
+    long long totalCycles = 0;
+    origin[current] += 16;
+    while (current != exit && totalCycles < maxCycles) {
+        int value = origin[current];
+        bool moved = false;
+        for (int direction = 0; direction < 4 && !moved; direction++) {
+            int *neighbor = &origin[current + step[direction]];
+            if ((value & directionOpening[direction]) && *neighbor < 16) {
+                *neighbor += 16 + 32 * directionOpposite[direction];
+                current += step[direction];
+                moved = true;
+            }
+        }
+        if (!moved) // Dead end, go back
+            current += step[(value >> 5) & 3];
+        totalCycles++;
+    }
+    return totalCycles;
+}
+
+// Runs kernelCall with dispatchRows, dispatchColumns, dispatchStride and dispatchSentinel as constants for the
+// specialized kernels, kernel is the kernel of the laberynth or paddedStrideKernel to run the values of the laberynth
+#define paddedCase(kernelCall, rowsValue, width, strideValue, sentinelValue) \
+    case width: { \
+        const int dispatchRows = rowsValue, dispatchColumns = width, dispatchStride = strideValue; \
+        const bool dispatchSentinel = sentinelValue; \
+        (void) dispatchSentinel; \
+        kernelCall; \
+        dispatched = true; \
+        break; \
+    }
+#define paddedShiftCase(kernelCall, width) paddedCase(kernelCall, (padded)->rows, width, width, false)
+#define paddedFixedCase(kernelCall, width) paddedCase(kernelCall, width, width, width + 1, true)
+#define paddedDispatch(kernelCall, padded, kernel) \
+    do { \
+        bool dispatched = false; \
+        if ((kernel) == paddedShiftKernel) { \
+            switch ((padded)->columns) { \
+            paddedShiftCase(kernelCall, 16) \
+            paddedShiftCase(kernelCall, 32) \
+            paddedShiftCase(kernelCall, 64) \
+            paddedShiftCase(kernelCall, 128) \
+            paddedShiftCase(kernelCall, 256) \
+            paddedShiftCase(kernelCall, 512) \
+            paddedShiftCase(kernelCall, 1024) \
+            paddedShiftCase(kernelCall, 2048) \
+            paddedShiftCase(kernelCall, 4096) \
+            } \
+        } else if ((kernel) == paddedFixedKernel) { \
+            switch ((padded)->columns) { \
+            paddedFixedCase(kernelCall, 5) \
+            paddedFixedCase(kernelCall, 10) \
+            paddedFixedCase(kernelCall, 20) \
+            paddedFixedCase(kernelCall, 50) \
+            paddedFixedCase(kernelCall, 100) \
+            } \
+        } \
+        if (!dispatched) { \
+            const int dispatchRows = (padded)->rows, dispatchColumns = (padded)->columns, dispatchStride = (padded)->stride; \
+            const bool dispatchSentinel = (padded)->sentinelColumn; \
+            (void) dispatchSentinel; \
+            kernelCall; \
+        } \
+    } while (0)
+
+void generatePaddedLaberynthWithKernel(PaddedLaberynth *padded, int kernel, unsigned long long seed) {
+    /*
+    Subroutine that builds the same laberynth as generateLaberynthCells with the same seed in a padded laberynth.
+    Inputs and constraints:
+        -kernel is padded->kernel or paddedStrideKernel.
+    */
+    paddedDispatch(generatePaddedKernel(padded->cells, padded->origin, padded->size, dispatchRows, dispatchColumns, dispatchStride,
+                                        dispatchSentinel, seed), padded, kernel);
+}
+
+void generatePaddedLaberynth(PaddedLaberynth *padded, unsigned long long seed) {
+    generatePaddedLaberynthWithKernel(padded, padded->kernel, seed);
+}
+
+long long randomMousePaddedWithKernel(PaddedLaberynth *padded, int kernel, long long maxCycles, unsigned long long seed) {
+    /*
+    Subroutine that runs the random mouse of randomMouseCells on a padded laberynth, with the same moves and marks.
+    Inputs and constraints:
+        -kernel is padded->kernel or paddedStrideKernel.
+    Outputs:
+        -The number of cycles needed to reach the exit, or maxCycles if it was not reached.
+    */
+    long long cycles = 0;
+    paddedDispatch(cycles = randomMousePaddedKernel(padded->origin, (long long) (dispatchRows - 1) * dispatchStride + dispatchColumns - 1,
+                                                    dispatchStride, maxCycles, seed), padded, kernel);
+    return cycles;
+}
+
+long long randomMousePadded(PaddedLaberynth *padded, long long maxCycles, unsigned long long seed) {
+    return randomMousePaddedWithKernel(padded, padded->kernel, maxCycles, seed);
+}
+
+long long tremauxPaddedWithKernel(PaddedLaberynth *padded, int kernel, long long maxCycles) {
+    /*
+    Subroutine that runs the Tremaux algorithm of tremauxCells on a padded laberynth, with the same moves and marks.
+    Inputs and constraints:
+        -kernel is padded->kernel or paddedStrideKernel.
+    Outputs:
+        -The number of cycles needed to reach the exit, or maxCycles if it was not reached.
+    */
+    long long cycles = 0;
+    paddedDispatch(cycles = tremauxPaddedKernel(padded->origin, (long long) (dispatchRows - 1) * dispatchStride + dispatchColumns - 1,
+                                                dispatchStride, maxCycles), padded, kernel);
+    return cycles;
+}
+
+long long tremauxPadded(PaddedLaberynth *padded, long long maxCycles) {
+    return tremauxPaddedWithKernel(padded, padded->kernel, maxCycles);
+}
+
+void benchmarkPaddedKernels(int rows, int columns, int mazes, long long steps) {
+    /*
+    Subroutine that generates and solves the same laberynths with the generic functions, with the padded kernels
+    on the runtime stride and with the padded kernels specialized for the size, checks that the laberynths and the
+    cycles are equal and compares the times.
+    */
+    int **generic = createMatrix(rows, columns);
+    int **unpadded = createMatrix(rows, columns);
+    PaddedLaberynth *padded = createPaddedLaberynth(rows, columns);
+    CellLayout layout = createCellLayout(rowMajorLayout, rows, columns);
+    int kernels[3] = {0, paddedStrideKernel, padded->kernel}; // The first one is the generic functions
+    double seconds[3][3] = {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}};
+    long long cycles[3][2] = {{0, 0}, {0, 0}, {0, 0}};
+    int differences = 0;
+
+    for (int maze = 0; maze < mazes; maze++) {
+        struct timespec start;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        generateLaberynthCells(generic[0], &layout, maze + 1);
+        seconds[0][0] += elapsedSeconds(start);
+        for (int version = 1; version < 3; version++) {
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            generatePaddedLaberynthWithKernel(padded, kernels[version], maze + 1);
+            seconds[version][0] += elapsedSeconds(start);
+            unpadLaberynth(padded, unpadded);
+            differences += memcmp(generic[0], unpadded[0], sizeof(int) * (size_t) rows * columns) != 0;
+
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            cycles[version][0] += randomMousePaddedWithKernel(padded, kernels[version], steps, maze + 1);
+            seconds[version][1] += elapsedSeconds(start);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &start); // After the comparisons, the mouse marks the cells
+        cycles[0][0] += randomMouseCells(generic[0], &layout, steps, maze + 1);
+        seconds[0][1] += elapsedSeconds(start);
+
+        generateLaberynthCells(generic[0], &layout, maze + 1);
+        for (int version = 0; version < 3; version++) {
+            if (version > 0)
+                generatePaddedLaberynthWithKernel(padded, kernels[version], maze + 1);
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            if (version == 0)
+                cycles[version][1] += tremauxCells(generic[0], &layout, steps);
+            else
+                cycles[version][1] += tremauxPaddedWithKernel(padded, kernels[version], steps);
+            seconds[version][2] += elapsedSeconds(start);
+            if (version > 0) {
+                unpadLaberynth(padded, unpadded);
+                differences += memcmp(generic[0], unpadded[0], sizeof(int) * (size_t) rows * columns) != 0;
+            }
+        }
+    }
+
+    printf("%d laberynths of %d x %d, kernel: %s (stride %d)\n", mazes, rows, columns, paddedKernelNames[padded->kernel], padded->stride);
+    printf("%-14s %14s %18s %18s\n", "", "generate s", "mouse steps/s", "tremaux steps/s");
+    const char *names[3] = {"generic", "padded stride", "specialized"};
+    for (int version = 0; version < 3; version++)
+        printf("%-14s %14.3f %18.0f %18.0f\n", names[version], seconds[version][0], cycles[version][0] / seconds[version][1],
+               cycles[version][1] / seconds[version][2]);
+    printf("Padded stride over generic: generate %.2fx, mouse %.2fx, tremaux %.2fx\n", seconds[0][0] / seconds[1][0],
+           seconds[0][1] / seconds[1][1], seconds[0][2] / seconds[1][2]);
+    if (padded->kernel == paddedStrideKernel)
+        printf("No specialized kernel for this size, the padded stride kernel is used\n");
+    else
+        printf("Specialized over padded stride: generate %.2fx, mouse %.2fx, tremaux %.2fx\n", seconds[1][0] / seconds[2][0],
+               seconds[1][1] / seconds[2][1], seconds[1][2] / seconds[2][2]);
+    bool sameCycles = cycles[0][0] == cycles[1][0] && cycles[0][0] == cycles[2][0] && cycles[0][1] == cycles[1][1] && cycles[0][1] == cycles[2][1];
+    printf("Same cycles: %s, different laberynths: %d\n", sameCycles ? "yes" : "no", differences);
+
+    freePaddedLaberynth(padded);
+    freeMatrix(generic, rows);
+    freeMatrix(unpadded, rows);
+}
+
+/*******************************Mouse Batches*******************************/
+/*
+Random mice for statistics over many small laberynths. All the laberynths of a batch have the same size and are
+stored one after the other in the padded format of the padded kernels with the sentinel column at every width
+(stride columns + 1, only the openings between cells, with 0 in the sentinels), so a mouse is only an index into one array. Instead of drawing directions until one is open, the
+move is the k-th open direction of the cell with k = random * count >> 16, looked up in a table of index steps
+built for the stride of the batch.
+The vector versions keep one mouse per lane (8 with AVX2, 16 with AVX-512): every step gathers the openings of the
+cells, the number of open directions and the step, and advances a xorshift32 generator per lane. When a lane
+reaches its exit or the maximum number of cycles it writes the cycles of its mouse and takes the next one, so all
+the lanes stay busy until the last mice; empty lanes wait on a sentinel, where the step is 0. Every mouse has its
+own generator seeded from its number, so the cycles of each mouse do not depend on the lane or the version, and
+the scalar version is the reference. The version is chosen at runtime from the instruction sets of the processor.
+*/
+
+#define mouseBatchMaxLanes 16
+
+typedef struct {
+    int mazes;
+    int rows;
+    int columns;
+    int stride;
+    int mazeSize;        // (rows + 2) * stride
+    int *cells;          // mazes * mazeSize openings
+    int moveCount[16];   // Open directions of each openings value
+    int moveStep[64];    // Index step of the k-th open direction of each value, at value * 4 + k
+} MouseBatch;
+
+typedef struct {
+    const MouseBatch *batch;
+    const int *startCells;   // Start cell (x * columns + y) of each mouse, or NULL for (0, 0)
+    int mice;                // Mouse i runs in laberynth i % mazes
+    int maxCycles;
+    unsigned long long seed;
+    int *cycles;             // Output, cycles of each mouse (maxCycles if it did not reach the exit)
+    int nextMouse;
+    int liveLanes;
+    int mouse[mouseBatchMaxLanes];
+    int position[mouseBatchMaxLanes];
+    int exit[mouseBatchMaxLanes];
+    int steps[mouseBatchMaxLanes];
+    int live[mouseBatchMaxLanes];
+    unsigned int random[mouseBatchMaxLanes];
+} MouseBatchRun;
+
+MouseBatch *createMouseBatch(int mazes, int rows, int columns) {
+    /*
+    Subroutine that allocates a batch of laberynths with the openings and steps tables for its stride.
+    Inputs and constraints:
+        -mazes, rows, columns: Number and size of the laberynths, all the cells must fit in an int index.
+    */
+    MouseBatch *batch = malloc(sizeof(MouseBatch));
+    batch->mazes = mazes;
+    batch->rows = rows;
+    batch->columns = columns;
+    batch->stride = columns + 1;
+    batch->mazeSize = (rows + 2) * batch->stride;
+    batch->cells = calloc((size_t) mazes * batch->mazeSize, sizeof(int));
+    const int step[4] = {-batch->stride, batch->stride, -1, 1};
+    for (int value = 0; value < 16; value++) {
+        int count = 0;
+        for (int direction = 0; direction < 4; direction++)
+            if (value & directionOpening[direction])
+                batch->moveStep[value * 4 + count++] = step[direction];
+        for (int k = count; k < 4; k++)
+            batch->moveStep[value * 4 + k] = 0;
+        batch->moveCount[value] = count;
+    }
+    return batch;
+}
+
+void freeMouseBatch(MouseBatch *batch) {
+    free(batch->cells);
+    free(batch);
+}
+
+void setMouseBatchMaze(MouseBatch *batch, int maze, int **matrix) {
+    /*
+    Subroutine that copies a laberynth into the batch, without the entrance and exit openings and the marks.
+    */
+    int *origin = batch->cells + (size_t) maze * batch->mazeSize + batch->stride;
+    for (int x = 0; x < batch->rows; x++)
+        for (int y = 0; y < batch->columns; y++)
+            origin[x * batch->stride + y] = insideOpenings(matrix, batch->rows, batch->columns, x, y) % 16;
+}
+
+static bool takeNextMouse(MouseBatchRun *run, int lane) {
+    /*
+    Subroutine that puts the next mouse that has to move in a lane, or leaves the lane empty on a sentinel.
+    Outputs:
+        -If the lane has a mouse.
+    */
+    const MouseBatch *batch = run->batch;
+    while (run->nextMouse < run->mice) {
+        int mouse = run->nextMouse++;
+        int start = run->startCells != NULL ? run->startCells[mouse] : 0;
+        int base = (mouse % batch->mazes) * batch->mazeSize + batch->stride;
+        int position = base + (start / batch->columns) * batch->stride + start % batch->columns;
+        int exit = base + (batch->rows - 1) * batch->stride + batch->columns - 1;
+        if (position == exit || run->maxCycles <= 0) {
+            run->cycles[mouse] = 0;
+            continue;
+        }
+        run->mouse[lane] = mouse;
+        run->position[lane] = position;
+        run->exit[lane] = exit;
+        run->steps[lane] = 0;
+        run->live[lane] = 1;
+        run->random[lane] = (unsigned int) mixBits(run->seed ^ mixBits(mouse)) | 1;
+        return true;
+    }
+    run->mouse[lane] = -1;
+    run->position[lane] = 0; // Sentinel of the first laberynth
+    run->exit[lane] = -1;
+    run->steps[lane] = 0;
+    run->live[lane] = 0;
+    run->random[lane] = 1;
+    return false;
+}
+
+static void startMouseLanes(MouseBatchRun *run, int lanes) {
+    run->nextMouse = 0;
+    run->liveLanes = 0;
+    for (int lane = 0; lane < mouseBatchMaxLanes; lane++)
+        run->liveLanes += lane < lanes ? takeNextMouse(run, lane) : 0;
+}
+
+static void finishMouseLanes(MouseBatchRun *run, unsigned int doneLanes) {
+    /*
+    Subroutine that writes the cycles of the mice of the finished lanes and refills them.
+    */
+    while (doneLanes != 0) {
+        int lane = __builtin_ctz(doneLanes);
+        doneLanes &= doneLanes - 1;
+        run->cycles[run->mouse[lane]] = run->steps[lane];
+        run->liveLanes -= !takeNextMouse(run, lane);
+    }
+}
+
+static inline unsigned int nextRandom32(unsigned int *state) {
+    /*
+    Subroutine that advances a 32 bit xorshift generator, the generator of the lanes.
+    References:
+        -Marsaglia, G. (2003). Xorshift RNGs. Journal of Statistical Software 8(14).
+    */
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+void mouseBatchScalar(MouseBatchRun *run) {
+    /*
+    Subroutine that runs the mice of a batch one after the other, the reference of the vector versions.
+    */
+    const MouseBatch *batch = run->batch;
+    startMouseLanes(run, 1);
+    while (run->liveLanes > 0) {
+        int position = run->position[0];
+        int steps = run->steps[0];
+        unsigned int random = run->random[0];
+        while (position != run->exit[0] && steps < run->maxCycles) {
+            int value = batch->cells[position];
+            int k = ((nextRandom32(&random) >> 16) * batch->moveCount[value]) >> 16;
+            position += batch->moveStep[value * 4 + k];
+            steps++;
+        }
+        run->steps[0] = steps;
+        finishMouseLanes(run, 1);
+    }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+__attribute__((target("avx2"))) void mouseBatchAVX2(MouseBatchRun *run) {
+    /*
+    Subroutine that runs the mice of a batch in the 8 lanes of AVX2 registers.
+    */
+    const MouseBatch *batch = run->batch;
+    startMouseLanes(run, 8);
+    __m256i position = _mm256_loadu_si256((const __m256i *) run->position);
+    __m256i exit = _mm256_loadu_si256((const __m256i *) run->exit);
+    __m256i steps = _mm256_loadu_si256((const __m256i *) run->steps);
+    __m256i live = _mm256_loadu_si256((const __m256i *) run->live);
+    __m256i random = _mm256_loadu_si256((const __m256i *) run->random);
+    const __m256i maxCycles = _mm256_set1_epi32(run->maxCycles);
+
+    while (run->liveLanes > 0) {
+        __m256i value = _mm256_i32gather_epi32(batch->cells, position, 4);
+        __m256i count = _mm256_i32gather_epi32(batch->moveCount, value, 4);
+        random = _mm256_xor_si256(random, _mm256_slli_epi32(random, 13));
+        random = _mm256_xor_si256(random, _mm256_srli_epi32(random, 17));
+        random = _mm256_xor_si256(random, _mm256_slli_epi32(random, 5));
+        __m256i k = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_srli_epi32(random, 16), count), 16);
+        __m256i step = _mm256_i32gather_epi32(batch->moveStep, _mm256_add_epi32(_mm256_slli_epi32(value, 2), k), 4);
+        position = _mm256_add_epi32(position, step);
+        steps = _mm256_add_epi32(steps, live);
+        __m256i done = _mm256_or_si256(_mm256_cmpeq_epi32(position, exit), _mm256_cmpeq_epi32(steps, maxCycles));
+        unsigned int doneLanes = _mm256_movemask_ps(_mm256_castsi256_ps(done));
+        if (doneLanes != 0) {
+            _mm256_storeu_si256((__m256i *) run->position, position);
+            _mm256_storeu_si256((__m256i *) run->steps, steps);
+            _mm256_storeu_si256((__m256i *) run->random, random);
+            finishMouseLanes(run, doneLanes);
+            position = _mm256_loadu_si256((const __m256i *) run->position);
+            exit = _mm256_loadu_si256((const __m256i *) run->exit);
+            steps = _mm256_loadu_si256((const __m256i *) run->steps);
+            live = _mm256_loadu_si256((const __m256i *) run->live);
+            random = _mm256_loadu_si256((const __m256i *) run->random);
+        }
+    }
+}
+
+__attribute__((target("avx512f"))) void mouseBatchAVX512(MouseBatchRun *run) {
+    /*
+    Subroutine that runs the mice of a batch in the 16 lanes of AVX-512 registers.
+    */
+    const MouseBatch *batch = run->batch;
+    startMouseLanes(run, 16);
+    __m512i position = _mm512_loadu_si512(run->position);
+    __m512i exit = _mm512_loadu_si512(run->exit);
+    __m512i steps = _mm512_loadu_si512(run->steps);
+    __m512i live = _mm512_loadu_si512(run->live);
+    __m512i random = _mm512_loadu_si512(run->random);
+    const __m512i maxCycles = _mm512_set1_epi32(run->maxCycles);
+    const __m512i moveCount = _mm512_loadu_si512(batch->moveCount);
+
+    while (run->liveLanes > 0) {
+        __m512i value = _mm512_i32gather_epi32(position, batch->cells, 4);
+        __m512i count = _mm512_permutexvar_epi32(value, moveCount);
+        random = _mm512_xor_si512(random, _mm512_slli_epi32(random, 13));
+        random = _mm512_xor_si512(random, _mm512_srli_epi32(random, 17));
+        random = _mm512_xor_si512(random, _mm512_slli_epi32(random, 5));
+        __m512i k = _mm512_srli_epi32(_mm512_mullo_epi32(_mm512_srli_epi32(random, 16), count), 16);
+        __m512i step = _mm512_i32gather_epi32(_mm512_add_epi32(_mm512_slli_epi32(value, 2), k), batch->moveStep, 4);
+        position = _mm512_add_epi32(position, step);
+        steps = _mm512_add_epi32(steps, live);
+        unsigned int doneLanes = _mm512_cmpeq_epi32_mask(position, exit) | _mm512_cmpeq_epi32_mask(steps, maxCycles);
+        if (doneLanes != 0) {
+            _mm512_storeu_si512(run->position, position);
+            _mm512_storeu_si512(run->steps, steps);
+            _mm512_storeu_si512(run->random, random);
+            finishMouseLanes(run, doneLanes);
+            position = _mm512_loadu_si512(run->position);
+            exit = _mm512_loadu_si512(run->exit);
+            steps = _mm512_loadu_si512(run->steps);
+            live = _mm512_loadu_si512(run->live);
+            random = _mm512_loadu_si512(run->random);
+        }
+    }
+}
+
+#endif
+
+const char *runMouseBatch(MouseBatchRun *run, int lanes) {
+    /*
+    Subroutine that runs the mice of a batch with the widest version the processor has, up to the lanes asked.
+    Inputs and constraints:
+        -run: Batch, mice, maximum cycles, seed and output array, the rest is filled here.
+        -lanes: 16, 8 or 1 (scalar), 0 for the widest available.
+    Outputs:
+        -The name of the version used.
+    */
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if ((lanes == 0 || lanes >= 16) && __builtin_cpu_supports("avx512f")) {
+        mouseBatchAVX512(run);
+        return "avx512";
+    }
+    if ((lanes == 0 || lanes >= 8) && __builtin_cpu_supports("avx2")) {
+        mouseBatchAVX2(run);
+        return "avx2";
+    }
+#endif
+    (void) lanes;
+    mouseBatchScalar(run);
+    return "scalar";
+}
+
+void benchmarkMouseBatch(int rows, int columns, int mazes, int miceEach, int maxCycles) {
+    /*
+    Subroutine that runs miceEach mice from (0, 0) in each of mazes laberynths with randomMouseCells and with every
+    version of the batch, checks that the versions agree mouse by mouse and compares the mouse steps per second.
+    */
+    int **matrix = createMatrix(rows, columns);
+    CellLayout layout = createCellLayout(rowMajorLayout, rows, columns);
+    MouseBatch *batch = createMouseBatch(mazes, rows, columns);
+    int mice = mazes * miceEach;
+    int *reference = malloc(sizeof(int) * mice);
+    int *cycles = malloc(sizeof(int) * mice);
+    long long genericSteps = 0;
+    double genericSeconds = 0;
+
+    for (int maze = 0; maze < mazes; maze++) {
+        generateLaberynthCells(matrix[0], &layout, maze + 1);
+        setMouseBatchMaze(batch, maze, matrix);
+        for (int mouse = 0; mouse < miceEach; mouse++) {
+            struct timespec start;
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            genericSteps += randomMouseCells(matrix[0], &layout, maxCycles, (unsigned long long) maze * miceEach + mouse);
+            genericSeconds += elapsedSeconds(start);
+            for (size_t index = 0; index < (size_t) rows * columns; index++)
+                matrix[0][index] %= 16;
+        }
+    }
+    printf("%d mice in %d laberynths of %d x %d\n", mice, mazes, rows, columns);
+    printf("%-16s %16s %14s %12s\n", "", "steps/s", "mean cycles", "speedup");
+    double genericRate = genericSteps / genericSeconds;
+    printf("%-16s %16.0f %14.1f %12s\n", "randomMouseCells", genericRate, (double) genericSteps / mice, "1.00x");
+
+    const int versionLanes[3] = {1, 8, 16};
+    for (int version = 0; version < 3; version++) {
+        MouseBatchRun run = {.batch = batch, .startCells = NULL, .mice = mice, .maxCycles = maxCycles, .seed = 7,
+                             .cycles = version == 0 ? reference : cycles};
+        struct timespec start;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        const char *name = runMouseBatch(&run, versionLanes[version]);
+        double seconds = elapsedSeconds(start);
+        if (version > 0 && strcmp(name, "scalar") == 0)
+            continue;
+        long long steps = 0;
+        for (int mouse = 0; mouse < mice; mouse++)
+            steps += run.cycles[mouse];
+        printf("%-16s %16.0f %14.1f %11.2fx", name, steps / seconds, (double) steps / mice, steps / seconds / genericRate);
+        if (version > 0)
+            printf("  %s", memcmp(reference, cycles, sizeof(int) * mice) == 0 ? "same cycles" : "DIFFERENT cycles");
+        printf("\n");
+    }
+
+    free(reference);
+    free(cycles);
+    freeMouseBatch(batch);
+    freeMatrix(matrix, rows);
+}
+
+/*******************************Main Program*******************************/
+
+void chunkedLaberynthDemo(unsigned long long seed) {
+    /*
+    Subroutine that runs both solvers on the infinite laberynth and reports how many chunks they needed.
+    */
+    ChunkedLaberynth *maze = createChunkedLaberynth(seed, 256);
+    long long exitX = chunkSize / 2;
+    long long exitY = chunkSize + 5;
+
+    long long cycles = randomMouseChunked(maze, 0, 0, exitX, exitY, 100000000, seed);
+    printf("Random Mouse Chunked: %lld cycles, %d chunks loaded, %llu generated\n", cycles, maze->loadedChunks, maze->generatedChunks);
+
+    long long pathLength = 0;
+    cycles = tremauxChunked(maze, 0, 0, exitX, exitY, 100000000, &pathLength);
+    printf("Tremaux Chunked: %lld cycles, path of %lld moves, %d chunks loaded, %llu generated\n", cycles, pathLength, maze->loadedChunks, maze->generatedChunks);
+
+    freeChunkedLaberynth(maze);
+}
+
+int main(int argc, char *argv[]) {
+    if (argc > 1 && strcmp(argv[1], "chunked") == 0) {
+        chunkedLaberynthDemo(argc > 2 ? strtoull(argv[2], NULL, 10) : (unsigned long long) time(NULL));
+        return 0;
+    }
+
+    if (argc > 1 && strcmp(argv[1], "layouts") == 0) {
+        int benchmarkRows = argc > 2 ? atoi(argv[2]) : 4096;
+        int benchmarkColumns = argc > 3 ? atoi(argv[3]) : 4096;
+        long long benchmarkSteps = argc > 4 ? atoll(argv[4]) : 100000000;
+        benchmarkCellLayouts(benchmarkRows, benchmarkColumns, benchmarkSteps, 1);
+        return 0;
+    }
+
+    if (argc > 1 && strcmp(argv[1], "packed") == 0) {
+        packedLaberynthDemo(argc > 2 ? atoi(argv[2]) : 1000, argc > 3 ? atoi(argv[3]) : 1000);
+        return 0;
+    }
+
+    if (argc > 1 && strcmp(argv[1], "junctions") == 0) {
+        junctionGraphDemo(argc > 2 ? atoi(argv[2]) : 1000, argc > 3 ? atoi(argv[3]) : 1000, argc > 4 ? atoi(argv[4]) : 10);
+        return 0;
+    }
+
+    if (argc > 1 && strcmp(argv[1], "queries") == 0) {
+        treeQueriesDemo(argc > 2 ? atoi(argv[2]) : 1000, argc > 3 ? atoi(argv[3]) : 1000, argc > 4 ? atoi(argv[4]) : 1000000);
+        return 0;
+    }
+
+    if (argc > 1 && strcmp(argv[1], "distances") == 0) {
+        distanceFieldDemo(argc > 2 ? atoi(argv[2]) : 1000, argc > 3 ? atoi(argv[3]) : 1000, argc > 4 ? atoi(argv[4]) : 0,
+                          argc > 5 ? argv[5] : NULL, argc > 6 ? argv[6] : NULL);
+        return 0;
+    }
+
+    if (argc > 1 && strcmp(argv[1], "dynamic") == 0) {
+        dynamicPathDemo(argc > 2 ? atoi(argv[2]) : 1000, argc > 3 ? atoi(argv[3]) : 1000, argc > 4 ? atoi(argv[4]) : 100000);
+        return 0;
+    }
+
+    if (argc > 5 && strcmp(argv[1], "generate") == 0) {
+        int generateRows = atoi(argv[2]);
+        int generateColumns = atoi(argv[3]);
+        int **generated = createMatrix(generateRows, generateColumns);
+        CellLayout layout = createCellLayout(rowMajorLayout, generateRows, generateColumns);
+        generateLaberynthCells(generated[0], &layout, strtoull(argv[4], NULL, 10));
+        bool saved = saveLaberynthBinary(argv[5], generated, generateRows, generateColumns);
+        freeMatrix(generated, generateRows);
+        if (!saved) {
+            printf("Could not write %s\n", argv[5]);
+            return 1;
+        }
+        return 0;
+    }
+
+    if (argc > 2 && strcmp(argv[1], "analytics") == 0) {
+        // Every remaining argument is a laberynth file, except a trailing number of threads
+        int threadCount = 0;
+        int lastFile = argc - 1;
+        if (lastFile > 2 && isdigit((unsigned char) argv[lastFile][0])) {
+            threadCount = atoi(argv[lastFile]);
+            lastFile--;
+        }
+        for (int file = 2; file <= lastFile; file++) {
+            PackedLaberynth *packed = mapLaberynthBinary(argv[file]);
+            if (packed == NULL) {
+                fprintf(stderr, "Could not map %s\n", argv[file]);
+                continue;
+            }
+            LaberynthAnalytics analytics = analyzeLaberynth(packed, threadCount);
+            printAnalyticsJSON(stdout, argv[file], packed, &analytics);
+            freePackedLaberynth(packed);
+        }
+        return 0;
+    }
+
+    if (argc > 2 && strcmp(argv[1], "validate") == 0) {
+        int threadCount = 0;
+        int lastFile = argc - 1;
+        if (lastFile > 2 && isdigit((unsigned char) argv[lastFile][0])) {
+            threadCount = atoi(argv[lastFile]);
+            lastFile--;
+        }
+        int invalidFiles = 0;
+        for (int file = 2; file <= lastFile; file++) {
+            PackedLaberynth *packed = mapLaberynthBinary(argv[file]);
+            if (packed == NULL) {
+                fprintf(stderr, "Could not map %s\n", argv[file]);
+                invalidFiles++;
+                continue;
+            }
+            LaberynthValidation validation = validatePackedLaberynth(packed, threadCount);
+            printValidation(stdout, argv[file], &validation);
+            invalidFiles += !validation.valid;
+            freePackedLaberynth(packed);
+        }
+        return invalidFiles > 0;
+    }
+
+    if (argc > 1 && strcmp(argv[1], "compress") == 0) {
+        compressionDemo(argc > 2 ? atoi(argv[2]) : 1000, argc > 3 ? atoi(argv[3]) : 1000, argc > 4 ? atoi(argv[4]) : 256,
+                        argc > 5 ? argv[5] : "laberynth.labz");
+        return 0;
+    }
+
+    if (argc > 1 && strcmp(argv[1], "solve") == 0) {
+        resumableSolversDemo(argc > 2 ? atoi(argv[2]) : 200, argc > 3 ? atoi(argv[3]) : 200, argc > 4 ? atoi(argv[4]) : 6,
+                             argc > 5 ? atoll(argv[5]) : 10000);
+        return 0;
+    }
+
+    if (argc > 1 && strcmp(argv[1], "render") == 0) {
+        renderDemo(argc > 2 ? atoi(argv[2]) : 100, argc > 3 ? atoi(argv[3]) : 100, argc > 4 ? atoi(argv[4]) : 4,
+                   argc > 5 ? atoi(argv[5]) : 1, argc > 6 ? argv[6] : "laberynth.ppm", argc > 7 ? argv[7] : "ph",
+                   argc > 8 ? atoi(argv[8]) : 0);
+        return 0;
+    }
+
+    if (argc > 2 && strcmp(argv[1], "serve") == 0)
+        return runJobServer(argv[2], argc > 3 ? atoi(argv[3]) : 0);
+
+    if (argc > 1 && strcmp(argv[1], "hierarchy") == 0) {
+        hierarchyDemo(argc > 2 ? atoi(argv[2]) : 1000, argc > 3 ? atoi(argv[3]) : 1000, argc > 4 ? atoi(argv[4]) : 32,
+                      argc > 5 ? atoi(argv[5]) : 100, argc > 6 ? atof(argv[6]) : 0.3);
+        return 0;
+    }
+
+    if (argc > 6 && strcmp(argv[1], "checkpoint") == 0) {
+        int generateRows = atoi(argv[2]);
+        int generateColumns = atoi(argv[3]);
+        int **generated = createMatrix(generateRows, generateColumns);
+        CellLayout layout = createCellLayout(rowMajorLayout, generateRows, generateColumns);
+        struct timespec start;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        bool checkpointFailed;
+        bool finished = generateLaberynthCheckpointed(generated[0], &layout, strtoull(argv[4], NULL, 10), argv[6],
+                                                      argc > 7 ? atoll(argv[7]) : 1 << 24, argc > 8 ? atoll(argv[8]) : 0, &checkpointFailed);
+        printf("%s in %.3f s\n", finished ? "Finished" : "Stopped", elapsedSeconds(start));
+        if (checkpointFailed) {
+            printf("Could not write the checkpoint %s\n", argv[6]);
+            freeMatrix(generated, generateRows);
+            return 1;
+        }
+        bool saved = !finished || saveLaberynthBinary(argv[5], generated, generateRows, generateColumns);
+        freeMatrix(generated, generateRows);
+        if (!saved) {
+            printf("Could not write %s\n", argv[5]);
+            return 1;
+        }
+        return finished ? 0 : 2;
+    }
+
+    if (argc > 1 && strcmp(argv[1], "hugepages") == 0) {
+        benchmarkAllocations(argc > 2 ? atoi(argv[2]) : 8192, argc > 3 ? atoi(argv[3]) : 8192, argc > 4 ? atoll(argv[4]) : 50000000,
+                             argc > 5 ? atoi(argv[5]) : threadsAvailable());
+        return 0;
+    }
+
+    if (argc > 1 && strcmp(argv[1], "kernels") == 0) {
+        benchmarkPaddedKernels(argc > 2 ? atoi(argv[2]) : 64, argc > 3 ? atoi(argv[3]) : 64, argc > 4 ? atoi(argv[4]) : 1000,
+                               argc > 5 ? atoll(argv[5]) : 1000000);
+        return 0;
+    }
+
+    if (argc > 1 && strcmp(argv[1], "mice") == 0) {
+        benchmarkMouseBatch(argc > 2 ? atoi(argv[2]) : 16, argc > 3 ? atoi(argv[3]) : 16, argc > 4 ? atoi(argv[4]) : 1000,
+                            argc > 5 ? atoi(argv[5]) : 10, argc > 6 ? atoi(argv[6]) : 1000000);
+        return 0;
+    }
+
+    int rows = 5;
+    int columns = 5;
+    int **matrix = createLaberynth(rows, columns);
+
+    printLaberynth(matrix, rows, columns);
+
+    printf("- - - - - - - - - - - - - - - - - - - - - \n");
+
+     //randomMouse(matrix, rows, columns);
+      //printf("Random Mouse \n");
+    //printLaberynth(matrix, rows, columns);
+   printf("Solve Maze \n");
+   tremaux(matrix, rows, columns);
+
+   printf("- - - - - - - - - - - - - - - - - - - - - \n");
+   printLaberynth(matrix, rows, columns);
+
+    return 0;
+}